@@ -1,12 +1,33 @@
 #include "BaseApp2D.h"
 #include <GLFW/glfw3.h>
 #include <cogra/gl/OpenGLRuntimeError.h>
+#include <imgui/imgui.h>
+#include <algorithm>
+#include <iostream>
 namespace cogra::ui
 {
-BaseApp2D::BaseApp2D(GLFWwindow* window) : GLFWApp(window) { }
+BaseApp2D::BaseApp2D(GLFWwindow* window)
+    : GLFWApp(window)
+    , m_window(window)
+    , m_isOnDemandRedrawEnabled(false)
+    , m_nPendingFrames(TrailingFrames)
+    , m_nSkippedFrames(0)
+    , m_nFrames(0)
+    , m_isRecording(false)
+    , m_isReplaying(false)
+    , m_startTime(0.0)
+    , m_startFrame(0)
+    , m_nextReplayedEvent(0)
+    , m_useRecordedTiming(false)
+    , m_closeWhenReplayed(false)
+    , m_replayedPointerPosition(0.0, 0.0)
+{
+}
 
-void BaseApp2D::onKey(int32_t key, int32_t, int32_t action, int32_t)
+void BaseApp2D::onKey(int32_t key, int32_t, int32_t action, int32_t mods)
 {
+    requestRedraw();
+    recordEvent(InputEvent::Key, key, action, mods);
     if(key == GLFW_KEY_F5 && action == GLFW_PRESS)
     {
         m_screenshot.triggerSaveToClipboard();
@@ -26,12 +47,13 @@ void BaseApp2D::onPostDraw()
 
 void BaseApp2D::onMouseButton(int32_t button, int32_t action, int32_t mods)
 {
-
+    requestRedraw();
+    recordEvent(InputEvent::MouseButton, button, action, mods);
     if(button == GLFW_MOUSE_BUTTON_2)
     {
         if(action == GLFW_PRESS)
         {
-            const auto d = getNormalizedMousePosition();
+            const auto d = getPointerPosition();
             m_transformationController.startTranslation(d);
         }
         else
@@ -44,7 +66,7 @@ void BaseApp2D::onMouseButton(int32_t button, int32_t action, int32_t mods)
     {
         if(action == GLFW_PRESS)
         {
-            const auto d = getNormalizedMousePosition();
+            const auto d = getPointerPosition();
             m_transformationController.startScale(d);
         }
         else
@@ -57,7 +79,9 @@ void BaseApp2D::onMouseButton(int32_t button, int32_t action, int32_t mods)
 
 void BaseApp2D::onCursorPosition(float64, float64)
 {
-    const auto d = getNormalizedMousePosition();
+    requestRedraw();
+    recordEvent(InputEvent::CursorPosition, 0, 0, 0);
+    const auto d = getPointerPosition();
     m_transformationController.updateTranslation(d);
     m_transformationController.updateScale(d);
 }
@@ -71,6 +95,7 @@ f32mat3 BaseApp2D::getCameraTransformation() const
 
 void BaseApp2D::onFramebufferSize(int width, int height)
 {
+    requestRedraw();
     GL_SAFE_CALL(glViewport(0, 0, width, height));
     m_aspectCorrection = (width < height) ? f32vec2(1.0f, static_cast<float>(width) / static_cast<float>(height)) : f32vec2(static_cast<float>(height) / static_cast<float>(width), 1.0f);
 }
@@ -86,4 +111,247 @@ float32 BaseApp2D::getScaleFactor() const
 {
     return m_transformationController.getScaleFactor();
 }
+
+
+void BaseApp2D::fitView(const f32vec2& min, const f32vec2& max)
+{
+    // The box spans 90 % of the normalized device coordinates [-1, 1] along its tighter axis.
+    const f32vec2 extent = max - min;
+    const float32 size = std::max(m_aspectCorrection.x * extent.x, m_aspectCorrection.y * extent.y);
+    const float32 scaleFactor = (size > 0.0f) ? 1.8f / size : m_transformationController.getScaleFactor();
+    m_transformationController.setView(-scaleFactor * 0.5f * (min + max), scaleFactor);
+    requestRedraw();
+}
+
+
+void BaseApp2D::waitForRedraw()
+{
+    if(!m_isOnDemandRedrawEnabled || m_isReplaying)
+    {
+        return;
+    }
+    if(m_nPendingFrames > 0)
+    {
+        m_nPendingFrames--;
+        return;
+    }
+
+    // ImGui changes some widgets without input: active items like repeating buttons and edited text fields,
+    // tooltips that appear after a delay, and the blinking text cursor.
+    if(ImGui::IsAnyItemActive())
+    {
+        return;
+    }
+
+    const float64 start = glfwGetTime();
+    if(ImGui::GetIO().WantTextInput || ImGui::IsAnyItemHovered() || ImGui::IsPopupOpen("", ImGuiPopupFlags_AnyPopupId))
+    {
+        glfwWaitEventsTimeout(WidgetRedrawInterval);
+    }
+    else
+    {
+        glfwWaitEvents();
+    }
+    const GLFWvidmode* videoMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    const float64 refreshRate = (videoMode != nullptr && videoMode->refreshRate > 0) ? videoMode->refreshRate : 60.0;
+    m_nSkippedFrames += static_cast<uint64>((glfwGetTime() - start) * refreshRate);
+
+    // Waking up counts as an event, even if no callback of this class was invoked.
+    m_nPendingFrames = TrailingFrames - 1;
+}
+
+
+void BaseApp2D::requestRedraw()
+{
+    m_nPendingFrames = std::max(m_nPendingFrames, TrailingFrames);
+}
+
+
+void BaseApp2D::setIsOnDemandRedrawEnabled(bool isEnabled)
+{
+    m_isOnDemandRedrawEnabled = isEnabled;
+    requestRedraw();
+}
+
+
+bool BaseApp2D::isOnDemandRedrawEnabled() const
+{
+    return m_isOnDemandRedrawEnabled;
+}
+
+
+uint64 BaseApp2D::getNumberOfSkippedFrames() const
+{
+    return m_nSkippedFrames;
+}
+
+
+f64vec2 BaseApp2D::getPointerPosition() const
+{
+    return m_isReplaying ? m_replayedPointerPosition : f64vec2(getNormalizedMousePosition());
+}
+
+
+void BaseApp2D::beginFrame()
+{
+    waitForRedraw();
+    m_nFrames++;
+    if(m_isReplaying)
+    {
+        dispatchReplayedEvents();
+    }
+}
+
+
+void BaseApp2D::endFrame()
+{
+    if(!m_isReplaying)
+    {
+        return;
+    }
+
+    // Include the GPU work of the frame in the latency.
+    GL_SAFE_CALL(glFinish());
+    const float64 now = glfwGetTime();
+    for(const float64 dispatchTime : m_dispatchTimes)
+    {
+        m_latencies.push_back(now - dispatchTime);
+    }
+    m_dispatchTimes.clear();
+
+    if(m_nextReplayedEvent == m_recording.events.size())
+    {
+        m_isReplaying = false;
+        m_replayStatistics = computeLatencyStatistics(std::move(m_latencies));
+        m_latencies.clear();
+        std::cout << "Replayed " << m_replayStatistics.nEvents << " events in " << (now - m_startTime) << " s, latency p50 "
+            << m_replayStatistics.p50Milliseconds << " ms, p99 " << m_replayStatistics.p99Milliseconds << " ms, max "
+            << m_replayStatistics.maxMilliseconds << " ms\n";
+        if(m_closeWhenReplayed)
+        {
+            glfwSetWindowShouldClose(m_window, GLFW_TRUE);
+        }
+    }
+}
+
+
+void BaseApp2D::startRecording()
+{
+    m_recording = InputRecording();
+    m_recording.framebufferWidth = getFramebufferWidth();
+    m_recording.framebufferHeight = getFramebufferHeight();
+    m_recording.scene = saveScene();
+    m_transformationController = TransformationController2D();
+    m_startTime = glfwGetTime();
+    m_startFrame = m_nFrames;
+    m_isRecording = true;
+}
+
+
+void BaseApp2D::stopRecording(const std::string& path)
+{
+    m_isRecording = false;
+    writeInputRecording(path, m_recording);
+}
+
+
+bool BaseApp2D::isRecording() const
+{
+    return m_isRecording;
+}
+
+
+void BaseApp2D::startReplay(const std::string& path, bool useRecordedTiming, bool closeWhenDone)
+{
+    m_recording = readInputRecording(path);
+    if(m_recording.framebufferWidth != getFramebufferWidth() || m_recording.framebufferHeight != getFramebufferHeight())
+    {
+        std::cerr << "The framebuffer size differs from the recording, so replayed pointer positions map to other scene positions\n";
+    }
+    loadScene(m_recording.scene);
+    m_transformationController = TransformationController2D();
+    m_isRecording = false;
+    m_isReplaying = true;
+    m_useRecordedTiming = useRecordedTiming;
+    m_closeWhenReplayed = closeWhenDone;
+    m_nextReplayedEvent = 0;
+    m_dispatchTimes.clear();
+    m_latencies.clear();
+    m_startTime = glfwGetTime();
+    m_startFrame = m_nFrames;
+}
+
+
+bool BaseApp2D::isReplaying() const
+{
+    return m_isReplaying;
+}
+
+
+const LatencyStatistics& BaseApp2D::getReplayStatistics() const
+{
+    return m_replayStatistics;
+}
+
+
+std::string BaseApp2D::saveScene() const
+{
+    return std::string();
+}
+
+
+void BaseApp2D::loadScene(const std::string&)
+{
+}
+
+
+void BaseApp2D::recordEvent(InputEvent::Type type, int32 button, int32 action, int32 mods)
+{
+    if(!m_isRecording)
+    {
+        return;
+    }
+    InputEvent e;
+    e.type = type;
+    e.time = glfwGetTime() - m_startTime;
+    e.frame = m_nFrames - m_startFrame;
+    e.button = button;
+    e.action = action;
+    e.mods = mods;
+    e.pointerPosition = getNormalizedMousePosition();
+    m_recording.events.push_back(e);
+}
+
+
+void BaseApp2D::dispatchReplayedEvents()
+{
+    const float64 now = glfwGetTime();
+    const uint64 frame = m_nFrames - m_startFrame;
+    while(m_nextReplayedEvent < m_recording.events.size())
+    {
+        const InputEvent& e = m_recording.events[m_nextReplayedEvent];
+        const bool isDue = m_useRecordedTiming ? (m_startTime + e.time <= now) : (e.frame <= frame);
+        if(!isDue)
+        {
+            break;
+        }
+        m_nextReplayedEvent++;
+
+        // With recorded timing, an event that is dispatched late has been waiting since it was due.
+        m_dispatchTimes.push_back(m_useRecordedTiming ? m_startTime + e.time : now);
+        m_replayedPointerPosition = e.pointerPosition;
+        switch(e.type)
+        {
+        case InputEvent::MouseButton:
+            onMouseButton(e.button, e.action, e.mods);
+            break;
+        case InputEvent::CursorPosition:
+            onCursorPosition(e.pointerPosition.x, e.pointerPosition.y);
+            break;
+        case InputEvent::Key:
+            onKey(e.button, 0, e.action, e.mods);
+            break;
+        }
+    }
+}
 }
\ No newline at end of file
@@ -3,7 +3,9 @@
 #include <cogra/ui/GLFWApp.h>
 #include <cogra/ui/GLFWWindow.h>
 #include "TransformationController2D.h"
+#include "InputRecording.h"
 #include <cogra/gl/Screenshot.h>
+#include <string>
 namespace cogra::ui
 {
 class BaseApp2D : public GLFWApp
@@ -27,13 +29,152 @@ public:
 
 	float32 getScaleFactor() const;
 
+	/// <summary>
+	/// Moves and scales the camera, such that the box is centered and fills the framebuffer up to a small margin.
+	/// </summary>
+	void fitView(const f32vec2& min, const f32vec2& max);
+
+	/// <summary>
+	/// In on-demand mode, blocks until a frame is needed. Call at the beginning of onDraw.
+	///
+	/// A frame is needed after any window or input event, after requestRedraw, and while an ImGui item is active.
+	/// Each of these renders a few trailing frames, as ImGui reacts to input one frame late. While ImGui edits text,
+	/// an item is hovered or a popup is open, frames are rendered at least every WidgetRedrawInterval seconds,
+	/// so that the text cursor blinks and delayed tooltips appear.
+	/// Continuous mode returns immediately.
+	/// </summary>
+	void waitForRedraw();
+
+	/// <summary>
+	/// Schedules frames in on-demand mode, e.g. after the scene changed. Call glfwPostEmptyEvent
+	/// instead from other threads to wake up the main loop.
+	/// </summary>
+	void requestRedraw();
+
+	void setIsOnDemandRedrawEnabled(bool isEnabled);
+
+	bool isOnDemandRedrawEnabled() const;
+
+	/// <summary>
+	/// Number of frames a continuous loop would have rendered at the refresh rate of the monitor
+	/// while waitForRedraw was blocking.
+	/// </summary>
+	uint64 getNumberOfSkippedFrames() const;
+
+	/// <summary>
+	/// Normalized pointer position. While replaying, the position of the replayed event instead.
+	/// Use it instead of getNormalizedMousePosition in input callbacks.
+	/// </summary>
+	f64vec2 getPointerPosition() const;
+
+	/// <summary>
+	/// Waits for a redraw and dispatches the replayed events that are due. Call at the beginning of onDraw.
+	/// </summary>
+	void beginFrame();
+
+	/// <summary>
+	/// Measures the latency of the events replayed in this frame. Call at the end of onDraw.
+	/// </summary>
+	void endFrame();
+
+	/// <summary>
+	/// Starts recording the viewport input. Saves the scene and resets the camera, so a replay starts from the same state.
+	/// Input to ImGui windows is not recorded.
+	/// </summary>
+	void startRecording();
+
+	/// <summary>
+	/// Stops recording and writes the recording to a file. Throws on failure.
+	/// </summary>
+	void stopRecording(const std::string& path);
+
+	bool isRecording() const;
+
+	/// <summary>
+	/// Restores the scene of a recording and feeds its events to the input callbacks.
+	///
+	/// With recorded timing, events are dispatched when they are due relative to the start of the replay. Otherwise
+	/// the events of one recorded frame are dispatched per frame without waiting. When all events are done, the
+	/// latency statistics are printed to the standard output. Throws if the file cannot be read.
+	/// </summary>
+	/// <param name="path">The recording.</param>
+	/// <param name="useRecordedTiming">Whether to reproduce the timing of the recording.</param>
+	/// <param name="closeWhenDone">Whether to close the window at the end of the replay.</param>
+	void startReplay(const std::string& path, bool useRecordedTiming, bool closeWhenDone);
+
+	bool isReplaying() const;
+
+	/// <summary>
+	/// Statistics of the last replay that ran to the end.
+	/// </summary>
+	const LatencyStatistics& getReplayStatistics() const;
+
+protected:
+	/// <summary>
+	/// Describes the current scene for a recording.
+	/// </summary>
+	virtual std::string saveScene() const;
+
+	/// <summary>
+	/// Restores a scene described by saveScene.
+	/// </summary>
+	virtual void loadScene(const std::string& scene);
+
 private:
+	//! Frames rendered after each event.
+	static constexpr uint32 TrailingFrames = 3;
+
+	//! Longest wait in seconds while ImGui may change without input, e.g., a hovered item whose tooltip appears after a delay.
+	static constexpr float64 WidgetRedrawInterval = 0.1;
+
+	void recordEvent(InputEvent::Type type, int32 button, int32 action, int32 mods);
+
+	void dispatchReplayedEvents();
+
+	GLFWwindow*                         m_window;
 
 	cogra::gl::Screenshot               m_screenshot;
 
 	cogra::ui::TransformationController2D    m_transformationController;
 
 	f32vec2                             m_aspectCorrection;
+
+	bool                                m_isOnDemandRedrawEnabled;
+
+	//! Frames to render before blocking again.
+	uint32                              m_nPendingFrames;
+
+	uint64                              m_nSkippedFrames;
+
+	//! Number of frames begun so far.
+	uint64                              m_nFrames;
+
+	bool                                m_isRecording;
+
+	bool                                m_isReplaying;
+
+	//! The recording that is written or replayed.
+	InputRecording                      m_recording;
+
+	//! Time and frame at which recording or replaying started.
+	float64                             m_startTime;
+
+	uint64                              m_startFrame;
+
+	size_t                              m_nextReplayedEvent;
+
+	bool                                m_useRecordedTiming;
+
+	bool                                m_closeWhenReplayed;
+
+	f64vec2                             m_replayedPointerPosition;
+
+	//! Dispatch times of the events replayed in the current frame.
+	std::vector<float64>                m_dispatchTimes;
+
+	std::vector<float64>                m_latencies;
+
+	LatencyStatistics                   m_replayStatistics;
 };
 
 
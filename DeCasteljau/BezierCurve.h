@@ -1,5 +1,10 @@
 #pragma once
 #include "PolynomialCurve.h"
+#include "BoundingBox.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
 namespace cogra
 {
 namespace gmca
@@ -11,48 +16,45 @@ public:
     typedef T vector_type;
     typedef typename T::value_type value_type;
 
+    /// <summary>
+    /// Differential quantities of the curve at one parameter value.
+    /// </summary>
+    struct Frame
+    {
+        vector_type position;
+
+        //! Unit tangent. Zero, if the first derivative vanishes.
+        vector_type tangent;
+
+        //! Signed curvature. Positive, if the curve turns counterclockwise.
+        value_type  curvature;
+    };
+
 
     BezierCurve(const std::vector<vector_type>& coefficients)
         : PolynomialCurve<T>::PolynomialCurve(coefficients)
         , m_binomialCoefficients(computeBinomialCoefficients())
+        , m_isBoundingBoxValid(false)
+        , m_areHodographsValid(false)
     {       
     }
 
     /// <summary>
     /// Compute and return the bionmial coefficients for the given degree.
+    /// Each coefficient follows from its predecessor, so constructing a curve allocates nothing but the result.
     /// </summary>
     /// <returns></returns>
     std::vector<value_type> computeBinomialCoefficients() const 
     { 
-        std::vector<value_type> result(PolynomialCurve<T>::getOrder() - 2, 1);
-        // Assignment 1(c) Implement me!
-        
-        const std::vector<value_type> b0 = { 1 };
-        const std::vector<value_type> b1 = { 1, 1 };
-        const std::vector<value_type> b2 = { 1, 2, 1 };
-        const std::vector<value_type> b3 = { 1, 3, 3, 1 };
-        const std::vector<value_type> b4 = { 1, 4, 6, 4, 1 };
-        const std::vector<value_type> b5 = { 1, 5, 10, 10, 5, 1 };
-        const std::vector<value_type> b6 = { 1, 6, 15, 20, 15, 6, 1 };
-        const std::vector<value_type> b7 = { 1, 7, 21, 35, 35, 21, 7, 1 };
-        /* const std::vector<value_type> b8 = {1, 8, 28,};
-        const std::vector<value_type> b9 = { 1 };
-        const std::vector<value_type> b10 = { 1 };*/
-
-        // compute n!
-        /*int n_fact = 0;
-        for (int i = 0; i < PolynomialCurve::getOrder(); i++)
+        const size_t n = PolynomialCurve<T>::getDegree();
+        std::vector<value_type> result;
+        result.reserve(n + 1);
+        value_type binomialCoefficient = 1;
+        for(size_t i = 0; i <= n; i++)
         {
-            n_fact += i;
+            result.push_back(binomialCoefficient);
+            binomialCoefficient = binomialCoefficient * static_cast<value_type>(n - i) / static_cast<value_type>(i + 1);
         }
-
-        for (int j = 0; j < PolynomialCurve::getOrder(); j++)
-        {
-            result.push_back()
-        }*/
-        const std::vector<std::vector<value_type>> coeff = { b0, b1, b2, b3, b4, b5, b6 };
-        result = coeff.at(PolynomialCurve<T>::getDegree());
-
         return result;
     }
 
@@ -73,6 +75,209 @@ public:
 		return r + up * PolynomialCurve<T>::getCoefficient(n);
     }
 
+    /// <summary>
+    /// Evaluates a Bezier curve given by its control points at t.
+    /// Same scheme as evaluate, but the binomial coefficients are computed on the fly, so it works for any degree.
+    /// </summary>
+    static vector_type evaluate(const std::vector<vector_type>& controlPoints, value_type t)
+    {
+        if(controlPoints.empty())
+        {
+            return vector_type(0);
+        }
+        const size_t n = controlPoints.size() - 1;
+        if(n == 0)
+        {
+            return controlPoints[0];
+        }
+        const value_type v = 1 - t;
+        value_type up = t;
+        value_type binomialCoefficient = 1;
+        vector_type r = v * controlPoints[0];
+        for(size_t i = 1; i < n; i++)
+        {
+            binomialCoefficient = binomialCoefficient * static_cast<value_type>(n - i + 1) / static_cast<value_type>(i);
+            r = v * (r + binomialCoefficient * up * controlPoints[i]);
+            up *= t;
+        }
+        return r + up * controlPoints[n];
+    }
+
+    const std::vector<vector_type>& getCoefficients() const
+    {
+        return PolynomialCurve<T>::getCoefficients();
+    }
+
+    /// <summary>
+    /// Returns the control points for editing. Invalidates all cached data derived from them.
+    /// Call invalidateCache if the returned reference is kept and used for later edits.
+    /// </summary>
+    std::vector<vector_type>& getCoefficients()
+    {
+        invalidateCache();
+        return PolynomialCurve<T>::getCoefficients();
+    }
+
+    /// <summary>
+    /// Discards the cached bounding box and hodographs. Must be called after the control points were changed.
+    /// </summary>
+    void invalidateCache()
+    {
+        m_isBoundingBoxValid = false;
+        m_areHodographsValid = false;
+    }
+
+    /// <summary>
+    /// Computes the cached bounding box and hodographs if they are outdated. Const member functions compute them on demand,
+    /// so a curve that is read by several threads at once must be updated before.
+    /// </summary>
+    void updateCache() const
+    {
+        updateBoundingBox();
+        updateHodographs();
+    }
+
+    /// <summary>
+    /// Computes only the cached bounding box if it is outdated. Containers of many curves keep the box up to date,
+    /// but not the hodographs, which would take more memory than the control points.
+    /// </summary>
+    void updateBoundingBox() const
+    {
+        if(!m_isBoundingBoxValid)
+        {
+            m_boundingBox = computeBoundingBox(PolynomialCurve<T>::getCoefficients());
+            m_isBoundingBoxValid = true;
+        }
+    }
+
+    /// <summary>
+    /// Returns the smallest axis aligned box that contains the curve. Unlike the box of the control points, it is tight.
+    /// </summary>
+    const BoundingBox<T>& getBoundingBox() const
+    {
+        updateBoundingBox();
+        return m_boundingBox;
+    }
+
+    /// <summary>
+    /// Computes the smallest axis aligned box that contains the Bezier curve given by its control points.
+    ///
+    /// Apart from the end points, a coordinate can only be extremal where its derivative, the first hodograph, vanishes.
+    /// Up to degree three, the hodograph is at most quadratic and its roots are computed in closed form. Higher degrees
+    /// isolate the roots by subdividing the Bernstein coefficients of the hodograph: by the variation diminishing
+    /// property, an interval whose coefficients do not change sign contains no root.
+    /// </summary>
+    static BoundingBox<T> computeBoundingBox(const std::vector<vector_type>& controlPoints)
+    {
+        BoundingBox<T> box;
+        if(controlPoints.empty())
+        {
+            return box;
+        }
+        box.extend(controlPoints.front());
+        box.extend(controlPoints.back());
+        const size_t order = controlPoints.size();
+        if(order > MaxRootFindingOrder + 1)
+        {
+            // Fall back to the box of the control points, which contains the curve as well.
+            for(const auto& p : controlPoints)
+            {
+                box.extend(p);
+            }
+            return box;
+        }
+
+        value_type hodograph[MaxRootFindingOrder];
+        value_type roots[MaxRoots];
+        for(int32 dimension = 0; dimension < 2; dimension++)
+        {
+            // The factor of the degree does not change the roots.
+            for(size_t i = 0; i + 1 < order; i++)
+            {
+                hodograph[i] = controlPoints[i + 1][dimension] - controlPoints[i][dimension];
+            }
+            const size_t nRoots = findBernsteinRoots(hodograph, order - 1, roots);
+            for(size_t i = 0; i < nRoots; i++)
+            {
+                box.extend(evaluate(controlPoints, roots[i]));
+            }
+        }
+        return box;
+    }
+
+    /// <summary>
+    /// Returns the control points of the first hodograph, i.e., the Bezier curve of degree n - 1 that is the first derivative.
+    /// </summary>
+    const std::vector<vector_type>& getFirstHodograph() const
+    {
+        updateHodographs();
+        return m_firstHodograph;
+    }
+
+    /// <summary>
+    /// Returns the control points of the second hodograph, i.e., the Bezier curve of degree n - 2 that is the second derivative.
+    /// </summary>
+    const std::vector<vector_type>& getSecondHodograph() const
+    {
+        updateHodographs();
+        return m_secondHodograph;
+    }
+
+    /// <summary>
+    /// Evaluates position, unit tangent and curvature at all parameters. The control points are converted to the power form
+    /// once per call, after which a single Horner pass per parameter yields the position and the first and second derivative.
+    /// Unlike evaluating the curve and both hodographs, it neither needs nor computes the cached hodographs.
+    /// </summary>
+    /// <param name="t">The parameters.</param>
+    /// <returns>One frame per parameter.</returns>
+    std::vector<Frame> evaluateFrames(const std::vector<value_type>& t) const
+    {
+        std::vector<Frame> result;
+        evaluateFrames(t, result);
+        return result;
+    }
+
+    /// <summary>
+    /// Same as evaluateFrames, but writes into result, so that its memory is reused by repeated calls.
+    /// </summary>
+    void evaluateFrames(const std::vector<value_type>& t, std::vector<Frame>& result) const
+    {
+        const size_t order = PolynomialCurve<T>::getOrder();
+        result.resize(t.size());
+        if(order <= MaxFrameOrder)
+        {
+            vector_type powerCoefficients[MaxFrameOrder];
+            evaluateFrames(t, powerCoefficients, result.data());
+        }
+        else
+        {
+            std::vector<vector_type> powerCoefficients(order);
+            evaluateFrames(t, powerCoefficients.data(), result.data());
+        }
+    }
+
+    /// <summary>
+    /// Computes the unit tangent and the signed curvature from the first and second derivative.
+    /// </summary>
+    static Frame computeFrame(const vector_type& position, const vector_type& firstDerivative, const vector_type& secondDerivative)
+    {
+        Frame frame;
+        frame.position = position;
+        const value_type squaredSpeed = firstDerivative.x * firstDerivative.x + firstDerivative.y * firstDerivative.y;
+        if(squaredSpeed > 0)
+        {
+            const value_type inverseSpeed = 1 / std::sqrt(squaredSpeed);
+            frame.tangent = inverseSpeed * firstDerivative;
+            frame.curvature = (firstDerivative.x * secondDerivative.y - firstDerivative.y * secondDerivative.x) * inverseSpeed * inverseSpeed * inverseSpeed;
+        }
+        else
+        {
+            frame.tangent = vector_type(0);
+            frame.curvature = 0;
+        }
+        return frame;
+    }
+
     void elevateDegree() 
     {
         // Assignment 3 Implement me!
@@ -145,6 +350,8 @@ public:
             leftCoefficients.push_back(level.at(0));
             rightCoefficients.push_back(level.at(level.size() - 1));
         }
+        // The right half was collected from its end point backwards.
+        std::reverse(rightCoefficients.begin(), rightCoefficients.end());
 
         return std::pair<BezierCurve<vector_type>, BezierCurve<vector_type>>(
             BezierCurve<vector_type>(leftCoefficients),
@@ -152,9 +359,314 @@ public:
     }
 
 
+    /// <summary>
+    /// Returns the part of the curve on the parameter interval [a, b] reparameterized to [0, 1].
+    ///
+    /// Control point i of the result is the blossom of the curve evaluated at (b, ..., b, a, ..., a) with
+    /// i arguments b, so all control points are computed directly without intermediate subdivisions.
+    /// b smaller than a reverses the direction; parameters outside the domain extrapolate.
+    /// </summary>
+    BezierCurve<vector_type> extract(value_type a, value_type b) const
+    {
+        std::vector<vector_type> levels;
+        std::vector<vector_type> work;
+        return BezierCurve<vector_type>(extractControlPoints(a, b, levels, work));
+    }
+
+    /// <summary>
+    /// Batched version of extract. The scratch memory is shared by all intervals.
+    /// </summary>
+    std::vector<BezierCurve<vector_type>> extractMany(const std::vector<std::pair<value_type, value_type>>& intervals) const
+    {
+        std::vector<BezierCurve<vector_type>> result;
+        result.reserve(intervals.size());
+        std::vector<vector_type> levels;
+        std::vector<vector_type> work;
+        for(const auto& interval : intervals)
+        {
+            result.emplace_back(extractControlPoints(interval.first, interval.second, levels, work));
+        }
+        return result;
+    }
+
 private:
+    //! Largest order of a hodograph whose roots are isolated. Curves of higher degree use the box of their control points.
+    static constexpr size_t MaxRootFindingOrder = 16;
+
+    //! Capacity for roots. A root on the boundary of two intervals may be reported twice.
+    static constexpr size_t MaxRoots = 2 * MaxRootFindingOrder;
+
+    //! Bound for the iterations of regula falsi on an interval with one root.
+    static constexpr int32 MaxRegulaFalsiSteps = 64;
+
+    //! Width of the parameter interval at which root isolation stops.
+    static constexpr value_type RootTolerance = value_type(1e-6);
+
+    //! Largest order for which evaluateFrames keeps its scratch memory on the stack.
+    static constexpr size_t MaxFrameOrder = 8;
+
+    /// <summary>
+    /// Evaluates the frames at the parameters t. powerCoefficients has room for the order of the curve.
+    ///
+    /// Coefficient j of the power form is binomial(n, j) times the j-th forward difference of the control points.
+    /// Horner's scheme for the polynomial, carried along for its derivatives, yields P, P' and P'' / 2.
+    /// The power form is as accurate as the Bernstein form up to degree four and loses a few bits beyond.
+    /// </summary>
+    void evaluateFrames(const std::vector<value_type>& t, vector_type* powerCoefficients, Frame* result) const
+    {
+        const auto& controlPoints = PolynomialCurve<T>::getCoefficients();
+        const size_t n = controlPoints.size() - 1;
+        std::copy(controlPoints.begin(), controlPoints.end(), powerCoefficients);
+        for(size_t j = 1; j <= n; j++)
+        {
+            for(size_t i = n; i >= j; i--)
+            {
+                powerCoefficients[i] -= powerCoefficients[i - 1];
+            }
+        }
+        value_type binomialCoefficient = 1;
+        for(size_t j = 1; j <= n; j++)
+        {
+            binomialCoefficient = binomialCoefficient * static_cast<value_type>(n - j + 1) / static_cast<value_type>(j);
+            powerCoefficients[j] *= binomialCoefficient;
+        }
+
+        for(size_t k = 0; k < t.size(); k++)
+        {
+            const value_type param = t[k];
+            vector_type position = powerCoefficients[n];
+            vector_type firstDerivative(0);
+            vector_type halfSecondDerivative(0);
+            for(size_t j = n; j-- > 0;)
+            {
+                halfSecondDerivative = halfSecondDerivative * param + firstDerivative;
+                firstDerivative = firstDerivative * param + position;
+                position = position * param + powerCoefficients[j];
+            }
+            result[k] = computeFrame(position, firstDerivative, value_type(2) * halfSecondDerivative);
+        }
+    }
+
+    /// <summary>
+    /// Finds the roots in (0, 1) of a polynomial given by n Bernstein coefficients.
+    /// </summary>
+    static size_t findBernsteinRoots(const value_type* b, size_t n, value_type* roots)
+    {
+        size_t nRoots = 0;
+        const auto addRoot = [&](value_type t)
+        {
+            if(t > 0 && t < 1)
+            {
+                roots[nRoots++] = t;
+            }
+        };
+        if(n == 2)
+        {
+            if((b[0] < 0) != (b[1] < 0))
+            {
+                addRoot(b[0] / (b[0] - b[1]));
+            }
+        }
+        else if(n == 3)
+        {
+            // a t^2 + bt + c in power form.
+            const value_type a = b[0] - 2 * b[1] + b[2];
+            const value_type bt = 2 * (b[1] - b[0]);
+            const value_type c = b[0];
+            const value_type scale = std::abs(b[0]) + std::abs(b[1]) + std::abs(b[2]);
+            if(std::abs(a) <= 16 * std::numeric_limits<value_type>::epsilon() * scale)
+            {
+                if(bt != 0)
+                {
+                    addRoot(-c / bt);
+                }
+            }
+            else
+            {
+                const value_type discriminant = bt * bt - 4 * a * c;
+                if(discriminant >= 0)
+                {
+                    // Avoids the cancellation of -b + sqrt(discriminant).
+                    const value_type q = -(bt + std::copysign(std::sqrt(discriminant), bt)) / 2;
+                    addRoot(q / a);
+                    if(q != 0)
+                    {
+                        addRoot(c / q);
+                    }
+                }
+            }
+        }
+        else if(n > 3)
+        {
+            isolateBernsteinRoots(b, n, 0, 1, roots, nRoots);
+        }
+        return nRoots;
+    }
+
+    static void isolateBernsteinRoots(const value_type* b, size_t n, value_type t0, value_type t1, value_type* roots, size_t& nRoots)
+    {
+        size_t nSignChanges = 0;
+        for(size_t i = 0; i + 1 < n; i++)
+        {
+            nSignChanges += (b[i] < 0) != (b[i + 1] < 0);
+        }
+        if(nSignChanges == 0 || nRoots == MaxRoots)
+        {
+            return;
+        }
+
+        if(nSignChanges == 1)
+        {
+            // Exactly one root. The Illinois variant of regula falsi finds it without further subdivisions.
+            value_type lo = 0;
+            value_type hi = 1;
+            value_type fLo = b[0];
+            value_type fHi = b[n - 1];
+            int32 side = 0;
+            value_type t = value_type(0.5);
+            for(int32 i = 0; i < MaxRegulaFalsiSteps && (hi - lo) * (t1 - t0) > RootTolerance; i++)
+            {
+                t = (lo * fHi - hi * fLo) / (fHi - fLo);
+                const value_type f = evaluateBernstein(b, n, t);
+                if(f == 0)
+                {
+                    break;
+                }
+                if((f < 0) == (fLo < 0))
+                {
+                    lo = t;
+                    fLo = f;
+                    // Halving the value at the end point that did not move avoids the one sided convergence of regula falsi.
+                    fHi = (side == -1) ? fHi / 2 : fHi;
+                    side = -1;
+                }
+                else
+                {
+                    hi = t;
+                    fHi = f;
+                    fLo = (side == 1) ? fLo / 2 : fLo;
+                    side = 1;
+                }
+            }
+            roots[nRoots++] = t0 + (t1 - t0) * t;
+            return;
+        }
+
+        const value_type mid = (t0 + t1) / 2;
+        if(t1 - t0 <= RootTolerance)
+        {
+            roots[nRoots++] = mid;
+            return;
+        }
+
+        // De Casteljau at 1/2 yields the coefficients of both halves.
+        value_type work[MaxRootFindingOrder];
+        value_type left[MaxRootFindingOrder];
+        value_type right[MaxRootFindingOrder];
+        std::copy(b, b + n, work);
+        for(size_t level = 0; level < n; level++)
+        {
+            const size_t size = n - level;
+            left[level] = work[0];
+            right[size - 1] = work[size - 1];
+            for(size_t i = 0; i + 1 < size; i++)
+            {
+                work[i] = (work[i] + work[i + 1]) / 2;
+            }
+        }
+        isolateBernsteinRoots(left, n, t0, mid, roots, nRoots);
+        isolateBernsteinRoots(right, n, mid, t1, roots, nRoots);
+    }
+
+    static value_type evaluateBernstein(const value_type* b, size_t n, value_type t)
+    {
+        value_type work[MaxRootFindingOrder];
+        std::copy(b, b + n, work);
+        for(size_t size = n; size > 1; size--)
+        {
+            for(size_t i = 0; i + 1 < size; i++)
+            {
+                work[i] = (1 - t) * work[i] + t * work[i + 1];
+            }
+        }
+        return work[0];
+    }
+
+    /// <summary>
+    /// Computes the control points blossom(b^i, a^(n - i)), i = 0, ..., n.
+    ///
+    /// levels holds the de Casteljau level of the curve after i steps with b. Reducing it with n - i
+    /// steps of a yields control point i. The cost is O(n^3) for degree n with scratch memory only.
+    /// </summary>
+    std::vector<vector_type> extractControlPoints(value_type a, value_type b, std::vector<vector_type>& levels, std::vector<vector_type>& work) const
+    {
+        const auto& coefficients = PolynomialCurve<T>::getCoefficients();
+        const size_t order = coefficients.size();
+        std::vector<vector_type> result;
+        result.reserve(order);
+        levels.assign(coefficients.begin(), coefficients.end());
+        for(size_t i = 0; i < order; i++)
+        {
+            const size_t levelSize = order - i;
+            work.assign(levels.begin(), levels.begin() + levelSize);
+            for(size_t size = levelSize; size > 1; size--)
+            {
+                for(size_t j = 0; j + 1 < size; j++)
+                {
+                    work[j] = (1 - a) * work[j] + a * work[j + 1];
+                }
+            }
+            result.push_back(work[0]);
+
+            for(size_t j = 0; j + 1 < levelSize; j++)
+            {
+                levels[j] = (1 - b) * levels[j] + b * levels[j + 1];
+            }
+        }
+        return result;
+    }
+
+    void updateHodographs() const
+    {
+        if(!m_areHodographsValid)
+        {
+            m_firstHodograph = computeHodograph(PolynomialCurve<T>::getCoefficients());
+            m_secondHodograph = computeHodograph(m_firstHodograph);
+            m_areHodographsValid = true;
+        }
+    }
+
+    /// <summary>
+    /// Computes the control points of a derivative: n * (b[i + 1] - b[i]).
+    /// </summary>
+    static std::vector<vector_type> computeHodograph(const std::vector<vector_type>& controlPoints)
+    {
+        std::vector<vector_type> result;
+        if(controlPoints.size() < 2)
+        {
+            return result;
+        }
+        const auto n = static_cast<value_type>(controlPoints.size() - 1);
+        result.reserve(controlPoints.size() - 1);
+        for(size_t i = 0; i + 1 < controlPoints.size(); i++)
+        {
+            result.push_back(n * (controlPoints[i + 1] - controlPoints[i]));
+        }
+        return result;
+    }
+
     std::vector<value_type>         m_binomialCoefficients;
 
+    mutable std::vector<vector_type> m_firstHodograph;
+
+    mutable std::vector<vector_type> m_secondHodograph;
+
+    mutable BoundingBox<T>          m_boundingBox;
+
+    mutable bool                    m_isBoundingBoxValid;
+
+    mutable bool                    m_areHodographsValid;
+
 };
 }
 }
\ No newline at end of file
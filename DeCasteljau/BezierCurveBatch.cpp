@@ -0,0 +1,267 @@
+#include "BezierCurveBatch.h"
+#include <cogra/exceptions/RuntimeError.h>
+#include <algorithm>
+#include <cmath>
+namespace cogra::gmca
+{
+namespace
+{
+constexpr size_t LaneWidth = BezierCurveBatch::LaneWidth;
+
+/// <summary>
+/// De Casteljau's algorithm on a block of LaneWidth curves. The order is a template parameter,
+/// so the loops over the control points are unrolled and only the loops over the lanes remain.
+/// </summary>
+template<uint32 Order>
+void evaluateBlock(const float32* coordinates, const float32* t, float32* x, float32* y)
+{
+    float32 bx[Order][LaneWidth];
+    float32 by[Order][LaneWidth];
+    for(uint32 i = 0; i < Order; i++)
+    {
+        for(size_t lane = 0; lane < LaneWidth; lane++)
+        {
+            bx[i][lane] = coordinates[i * LaneWidth + lane];
+            by[i][lane] = coordinates[(Order + i) * LaneWidth + lane];
+        }
+    }
+
+    for(uint32 level = Order - 1; level > 0; level--)
+    {
+        for(uint32 i = 0; i < level; i++)
+        {
+            for(size_t lane = 0; lane < LaneWidth; lane++)
+            {
+                bx[i][lane] += t[lane] * (bx[i + 1][lane] - bx[i][lane]);
+                by[i][lane] += t[lane] * (by[i + 1][lane] - by[i][lane]);
+            }
+        }
+    }
+
+    for(size_t lane = 0; lane < LaneWidth; lane++)
+    {
+        x[lane] = bx[0][lane];
+        y[lane] = by[0][lane];
+    }
+}
+
+using BlockFunction = void(*)(const float32*, const float32*, float32*, float32*);
+
+//! Entry i evaluates curves of order i + 1.
+constexpr BlockFunction BlockFunctions[BezierCurveBatch::MaxOrder] =
+{
+    evaluateBlock<1>, evaluateBlock<2>, evaluateBlock<3>, evaluateBlock<4>, evaluateBlock<5>, evaluateBlock<6>, evaluateBlock<7>
+};
+
+//! Largest order whose bounding boxes are computed in closed form.
+constexpr uint32 MaxClosedFormOrder = 4;
+
+/// <summary>
+/// Range of one coordinate of a block of curves up to degree three.
+///
+/// The candidates besides the end points are the roots of the hodograph clamped to [0, 1]. A clamped or otherwise
+/// invalid candidate is still a point on the curve, so it does not enlarge the range, and all lanes run the same
+/// instructions without branches.
+/// </summary>
+template<uint32 Order>
+void computeBlockRange(const float32* coordinates, float32* minima, float32* maxima)
+{
+    for(size_t lane = 0; lane < LaneWidth; lane++)
+    {
+        float32 p[Order];
+        for(uint32 i = 0; i < Order; i++)
+        {
+            p[i] = coordinates[i * LaneWidth + lane];
+        }
+        float32 minimum = std::min(p[0], p[Order - 1]);
+        float32 maximum = std::max(p[0], p[Order - 1]);
+        if constexpr(Order == 3)
+        {
+            const float32 h0 = p[1] - p[0];
+            const float32 denominator = h0 - (p[2] - p[1]);
+            const float32 t = std::clamp(denominator != 0.0f ? h0 / denominator : 0.0f, 0.0f, 1.0f);
+            const float32 s = 1.0f - t;
+            const float32 value = s * s * p[0] + 2.0f * s * t * p[1] + t * t * p[2];
+            minimum = std::min(minimum, value);
+            maximum = std::max(maximum, value);
+        }
+        else if constexpr(Order == 4)
+        {
+            // The hodograph is a t^2 + b t + c in power form.
+            const float32 h0 = p[1] - p[0];
+            const float32 h1 = p[2] - p[1];
+            const float32 h2 = p[3] - p[2];
+            const float32 a = h0 - 2.0f * h1 + h2;
+            const float32 b = 2.0f * (h1 - h0);
+            const float32 discriminant = b * b - 4.0f * a * h0;
+            // Avoids the cancellation of -b + sqrt(discriminant). For a close to zero, the second root
+            // approaches the root of the linear part and the first one leaves [0, 1].
+            const float32 q = -0.5f * (b + std::copysign(std::sqrt(std::max(discriminant, 0.0f)), b));
+            float32 t[2] =
+            {
+                (a != 0.0f) ? q / a : 0.0f,
+                (q != 0.0f) ? h0 / q : 0.0f
+            };
+            for(float32 ti : t)
+            {
+                ti = (discriminant >= 0.0f) ? std::clamp(ti, 0.0f, 1.0f) : 0.0f;
+                const float32 s = 1.0f - ti;
+                const float32 value = s * s * s * p[0] + 3.0f * s * ti * (s * p[1] + ti * p[2]) + ti * ti * ti * p[3];
+                minimum = std::min(minimum, value);
+                maximum = std::max(maximum, value);
+            }
+        }
+        minima[lane] = minimum;
+        maxima[lane] = maximum;
+    }
+}
+
+using RangeFunction = void(*)(const float32*, float32*, float32*);
+
+//! Entry i computes the ranges of curves of order i + 1.
+constexpr RangeFunction RangeFunctions[MaxClosedFormOrder] =
+{
+    computeBlockRange<1>, computeBlockRange<2>, computeBlockRange<3>, computeBlockRange<4>
+};
+}
+
+BezierCurveBatch::BezierCurveBatch(const BezierSpline& spline)
+    : m_nCurves(spline.getNumberOfCurves())
+{
+    std::vector<std::vector<uint32>> curvesByOrder(MaxOrder + 1);
+    uint32 curveIdx = 0;
+    for(const auto& curve : spline)
+    {
+        const size_t order = curve.getCoefficients().size();
+        if(order == 0 || order > MaxOrder)
+        {
+            throw cogra::exceptions::RuntimeError("BezierCurveBatch supports curves up to degree six");
+        }
+        curvesByOrder[order].push_back(curveIdx++);
+    }
+
+    for(uint32 order = 1; order <= MaxOrder; order++)
+    {
+        if(curvesByOrder[order].empty())
+        {
+            continue;
+        }
+        Bucket bucket;
+        bucket.order = order;
+        bucket.curveIndices = std::move(curvesByOrder[order]);
+
+        // Padding lanes evaluate the last curve again and write the same position.
+        const size_t nBlocks = (bucket.curveIndices.size() + LaneWidth - 1) / LaneWidth;
+        bucket.curveIndices.resize(nBlocks * LaneWidth, bucket.curveIndices.back());
+        bucket.coordinates.resize(nBlocks * 2 * order * LaneWidth);
+        for(size_t j = 0; j < bucket.curveIndices.size(); j++)
+        {
+            const auto& controlPoints = spline.getCurve(bucket.curveIndices[j]).getCoefficients();
+            float32* block = &bucket.coordinates[(j / LaneWidth) * 2 * order * LaneWidth];
+            const size_t lane = j % LaneWidth;
+            for(uint32 i = 0; i < order; i++)
+            {
+                block[i * LaneWidth + lane] = controlPoints[i].x;
+                block[(order + i) * LaneWidth + lane] = controlPoints[i].y;
+            }
+        }
+        m_buckets.push_back(std::move(bucket));
+    }
+}
+
+template<class ParameterFunction>
+void BezierCurveBatch::evaluateBuckets(ParameterFunction parameters, std::vector<f32vec2>& positions) const
+{
+    positions.resize(m_nCurves);
+    float32 t[LaneWidth];
+    float32 x[LaneWidth];
+    float32 y[LaneWidth];
+    for(const auto& bucket : m_buckets)
+    {
+        const BlockFunction evaluateBlock = BlockFunctions[bucket.order - 1];
+        const size_t blockSize = 2 * bucket.order * LaneWidth;
+        for(size_t first = 0; first < bucket.curveIndices.size(); first += LaneWidth)
+        {
+            const uint32* curveIndices = &bucket.curveIndices[first];
+            parameters(curveIndices, t);
+            evaluateBlock(&bucket.coordinates[(first / LaneWidth) * blockSize], t, x, y);
+            for(size_t lane = 0; lane < LaneWidth; lane++)
+            {
+                positions[curveIndices[lane]] = f32vec2(x[lane], y[lane]);
+            }
+        }
+    }
+}
+
+void BezierCurveBatch::evaluate(float32 t, std::vector<f32vec2>& positions) const
+{
+    evaluateBuckets([t](const uint32*, float32* laneParameters)
+    {
+        for(size_t lane = 0; lane < LaneWidth; lane++)
+        {
+            laneParameters[lane] = t;
+        }
+    }, positions);
+}
+
+void BezierCurveBatch::evaluate(const std::vector<float32>& t, std::vector<f32vec2>& positions) const
+{
+    if(t.size() != m_nCurves)
+    {
+        throw cogra::exceptions::RuntimeError("BezierCurveBatch::evaluate requires one parameter per curve");
+    }
+    evaluateBuckets([&t](const uint32* curveIndices, float32* laneParameters)
+    {
+        for(size_t lane = 0; lane < LaneWidth; lane++)
+        {
+            laneParameters[lane] = t[curveIndices[lane]];
+        }
+    }, positions);
+}
+
+void BezierCurveBatch::computeBoundingBoxes(std::vector<BoundingBox<f32vec2>>& boxes) const
+{
+    boxes.resize(m_nCurves);
+    float32 minX[LaneWidth];
+    float32 maxX[LaneWidth];
+    float32 minY[LaneWidth];
+    float32 maxY[LaneWidth];
+    std::vector<f32vec2> controlPoints;
+    for(const auto& bucket : m_buckets)
+    {
+        const size_t blockSize = 2 * bucket.order * LaneWidth;
+        for(size_t first = 0; first < bucket.curveIndices.size(); first += LaneWidth)
+        {
+            const float32* block = &bucket.coordinates[(first / LaneWidth) * blockSize];
+            if(bucket.order <= MaxClosedFormOrder)
+            {
+                const RangeFunction computeRange = RangeFunctions[bucket.order - 1];
+                computeRange(block, minX, maxX);
+                computeRange(block + bucket.order * LaneWidth, minY, maxY);
+                for(size_t lane = 0; lane < LaneWidth; lane++)
+                {
+                    auto& box = boxes[bucket.curveIndices[first + lane]];
+                    box.min = f32vec2(minX[lane], minY[lane]);
+                    box.max = f32vec2(maxX[lane], maxY[lane]);
+                }
+                continue;
+            }
+
+            for(size_t lane = 0; lane < LaneWidth; lane++)
+            {
+                controlPoints.resize(bucket.order);
+                for(uint32 i = 0; i < bucket.order; i++)
+                {
+                    controlPoints[i] = f32vec2(block[i * LaneWidth + lane], block[(bucket.order + i) * LaneWidth + lane]);
+                }
+                boxes[bucket.curveIndices[first + lane]] = BezierCurve<f32vec2>::computeBoundingBox(controlPoints);
+            }
+        }
+    }
+}
+
+size_t BezierCurveBatch::getNumberOfCurves() const
+{
+    return m_nCurves;
+}
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cogra/types.h>
+#include <vector>
+#include "BezierSpline.h"
+namespace cogra::gmca
+{
+/// <summary>
+/// Copy of the curves of a spline in a layout for evaluating many curves at once with SIMD instructions.
+///
+/// Curves are bucketed by degree. Within a bucket, blocks of LaneWidth curves are interleaved, such that the
+/// x coordinates of control point i of all curves of a block are adjacent, followed by their y coordinates.
+/// The evaluation runs de Casteljau's algorithm on whole blocks, with the innermost loops over the lanes,
+/// which compilers turn into vector instructions. The last block of a bucket is padded with copies of its
+/// last curve.
+/// </summary>
+class BezierCurveBatch
+{
+public:
+    //! Number of curves per block. Eight floats fill an AVX register, two of them an AVX-512 register.
+    static constexpr size_t LaneWidth = 8;
+
+    //! BezierCurve supports up to degree six.
+    static constexpr uint32 MaxOrder = 7;
+
+    /// <summary>
+    /// Copies the control points of all curves of the spline. Throws if a curve has a degree above six.
+    /// </summary>
+    explicit BezierCurveBatch(const BezierSpline& spline);
+
+    /// <summary>
+    /// Evaluates all curves at the same parameter.
+    /// </summary>
+    /// <param name="t">The parameter.</param>
+    /// <param name="positions">Resized to the number of curves. Entry i is the position on curve i of the spline.</param>
+    void evaluate(float32 t, std::vector<f32vec2>& positions) const;
+
+    /// <summary>
+    /// Evaluates curve i at parameter t[i].
+    /// </summary>
+    /// <param name="t">One parameter per curve.</param>
+    /// <param name="positions">Resized to the number of curves. Entry i is the position on curve i of the spline.</param>
+    void evaluate(const std::vector<float32>& t, std::vector<f32vec2>& positions) const;
+
+    /// <summary>
+    /// Computes the exact bounding box of every curve, like BezierCurve::computeBoundingBox.
+    /// Up to degree three, the closed form roots of the hodographs are computed for whole blocks at once.
+    /// Higher degrees isolate the roots curve by curve.
+    /// </summary>
+    /// <param name="boxes">Resized to the number of curves. Entry i is the box of curve i of the spline.</param>
+    void computeBoundingBoxes(std::vector<BoundingBox<f32vec2>>& boxes) const;
+
+    size_t getNumberOfCurves() const;
+
+private:
+    /// <summary>
+    /// All curves of one degree.
+    /// </summary>
+    struct Bucket
+    {
+        uint32                  order = 0;
+
+        //! Index in the spline of each curve of the bucket.
+        std::vector<uint32>     curveIndices;
+
+        //! Per block: order x coordinates of LaneWidth lanes, then order y coordinates.
+        std::vector<float32>    coordinates;
+    };
+
+    template<class ParameterFunction>
+    void evaluateBuckets(ParameterFunction parameters, std::vector<f32vec2>& positions) const;
+
+    std::vector<Bucket>     m_buckets;
+
+    size_t                  m_nCurves;
+};
+}
@@ -0,0 +1,97 @@
+#include "BezierCurvesDrawable.h"
+#include <cogra/exceptions/RuntimeError.h>
+#include <cogra/gl/OpenGLRuntimeError.h>
+#include <string>
+#include <utility>
+namespace cogra::gmca
+{
+BezierCurvesDrawable::BezierCurvesDrawable(const BezierSpline& spline)
+    : m_vertexArray(0)
+    , m_buffer(0)
+    , m_texture(0)
+    , m_nCurves(static_cast<GLsizei>(spline.getNumberOfCurves()))
+{
+    std::vector<f32vec2> texels(spline.getNumberOfCurves() * TexelsPerCurve, f32vec2(0.0f, 0.0f));
+    size_t i = 0;
+    for(const auto& curve : spline)
+    {
+        const auto& controlPoints = curve.getCoefficients();
+        if(controlPoints.size() > MaxControlPoints)
+        {
+            throw cogra::exceptions::RuntimeError("BezierCurvesDrawable supports at most " + std::to_string(MaxControlPoints) + " control points");
+        }
+        std::copy(controlPoints.begin(), controlPoints.end(), texels.begin() + i * TexelsPerCurve);
+        texels[i * TexelsPerCurve + MaxControlPoints].x = static_cast<float32>(controlPoints.size());
+        i++;
+    }
+
+    GL_SAFE_CALL(glGenVertexArrays(1, &m_vertexArray));
+
+    GL_SAFE_CALL(glGenBuffers(1, &m_buffer));
+    GL_SAFE_CALL(glBindBuffer(GL_TEXTURE_BUFFER, m_buffer));
+    GL_SAFE_CALL(glBufferData(GL_TEXTURE_BUFFER, texels.size() * sizeof(f32vec2), texels.data(), GL_STATIC_DRAW));
+    GL_SAFE_CALL(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+
+    GL_SAFE_CALL(glGenTextures(1, &m_texture));
+    GL_SAFE_CALL(glBindTexture(GL_TEXTURE_BUFFER, m_texture));
+    GL_SAFE_CALL(glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, m_buffer));
+    GL_SAFE_CALL(glBindTexture(GL_TEXTURE_BUFFER, 0));
+}
+
+BezierCurvesDrawable::~BezierCurvesDrawable()
+{
+    release();
+}
+
+BezierCurvesDrawable::BezierCurvesDrawable(BezierCurvesDrawable&& other) noexcept
+    : m_vertexArray(std::exchange(other.m_vertexArray, 0))
+    , m_buffer(std::exchange(other.m_buffer, 0))
+    , m_texture(std::exchange(other.m_texture, 0))
+    , m_nCurves(std::exchange(other.m_nCurves, 0))
+{
+}
+
+BezierCurvesDrawable& BezierCurvesDrawable::operator=(BezierCurvesDrawable&& other) noexcept
+{
+    if(this != &other)
+    {
+        release();
+        m_vertexArray = std::exchange(other.m_vertexArray, 0);
+        m_buffer = std::exchange(other.m_buffer, 0);
+        m_texture = std::exchange(other.m_texture, 0);
+        m_nCurves = std::exchange(other.m_nCurves, 0);
+    }
+    return *this;
+}
+
+void BezierCurvesDrawable::draw(uint32 textureUnit) const
+{
+    if(m_nCurves < 1)
+    {
+        return;
+    }
+    GL_SAFE_CALL(glBindVertexArray(m_vertexArray));
+    GL_SAFE_CALL(glActiveTexture(GL_TEXTURE0 + textureUnit));
+    GL_SAFE_CALL(glBindTexture(GL_TEXTURE_BUFFER, m_texture));
+    GL_SAFE_CALL(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_nCurves));
+}
+
+void BezierCurvesDrawable::release()
+{
+    if(m_texture != 0)
+    {
+        glDeleteTextures(1, &m_texture);
+    }
+    if(m_buffer != 0)
+    {
+        glDeleteBuffers(1, &m_buffer);
+    }
+    if(m_vertexArray != 0)
+    {
+        glDeleteVertexArrays(1, &m_vertexArray);
+    }
+    m_texture = 0;
+    m_buffer = 0;
+    m_vertexArray = 0;
+}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <glad/glad.h>
+#include <cogra/types.h>
+#include <vector>
+#include "BezierSpline.h"
+namespace cogra::gmca
+{
+/// <summary>
+/// GPU data for drawing Bezier curves directly from their control points, without sampling them.
+///
+/// The control points of curve i are stored in texels [i * TexelsPerCurve, (i + 1) * TexelsPerCurve) of a
+/// buffer texture. The last texel of each curve holds the number of control points in x. Curve i is drawn
+/// as instance i of a four vertex triangle strip that covers the convex hull of its control points.
+/// </summary>
+class BezierCurvesDrawable
+{
+public:
+    //! Curves up to degree six are supported, which is the largest degree of BezierCurve.
+    static constexpr uint32 MaxControlPoints = 7;
+
+    static constexpr uint32 TexelsPerCurve = MaxControlPoints + 1;
+
+    /// <summary>
+    /// Uploads the control points of all curves of the spline. Throws if a curve has more than MaxControlPoints control points.
+    /// </summary>
+    explicit BezierCurvesDrawable(const BezierSpline& spline);
+
+    ~BezierCurvesDrawable();
+
+    BezierCurvesDrawable(const BezierCurvesDrawable&) = delete;
+
+    BezierCurvesDrawable& operator=(const BezierCurvesDrawable&) = delete;
+
+    BezierCurvesDrawable(BezierCurvesDrawable&& other) noexcept;
+
+    BezierCurvesDrawable& operator=(BezierCurvesDrawable&& other) noexcept;
+
+    /// <summary>
+    /// Draws one quad per curve. The control points are bound to the given texture unit.
+    /// </summary>
+    void draw(uint32 textureUnit = 0) const;
+
+private:
+    void release();
+
+    GLuint                  m_vertexArray;
+
+    GLuint                  m_buffer;
+
+    GLuint                  m_texture;
+
+    GLsizei                 m_nCurves;
+};
+}
@@ -1,7 +1,164 @@
 #include "BezierSpline.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include "CubicFitting.h"
 namespace cogra::gmca
 {
+namespace
+{
+//! Number of samples per curve that the merged curve has to approximate.
+constexpr size_t SamplesPerCurve = 16;
+
+//! Upper bound for the number of curves merged into one. Bounds the cost of the greedy refits.
+constexpr size_t MaxCurvesPerMerge = 64;
+
+struct RunResult
+{
+	std::vector<BezierCurve<f32vec2>> curves;
+
+	SimplificationResult statistics;
+};
+
+f32vec2 normalizeOr(const f32vec2& v, const f32vec2& fallback)
+{
+	const float32 l = std::sqrt(v.x * v.x + v.y * v.y);
+	return (l > 0.0f) ? v / l : fallback;
+}
+
+/// <summary>
+/// Greedily merges the adjacent curves [first, last).
+/// </summary>
+RunResult simplifyRun(const BezierSpline& spline, uint32 first, uint32 last, float32 tolerance)
+{
+	RunResult result;
+	const float32 squaredTolerance = tolerance * tolerance;
+	std::vector<f32vec2> samples;
+	uint32 i = first;
+	while(i < last)
+	{
+		// Samples of the curves [i, j), without duplicating the shared end points.
+		samples.assign(1, spline.getCurve(i).getCoefficient(0));
+		CubicFit bestFit;
+		uint32 bestEnd = i + 1;
+		for(uint32 j = i + 1; j <= last && j - i <= MaxCurvesPerMerge; j++)
+		{
+			auto curveSamples = spline.getCurve(j - 1).sample(SamplesPerCurve);
+			samples.insert(samples.end(), curveSamples.begin() + 1, curveSamples.end());
+			if(j - i < 2)
+			{
+				continue;
+			}
+
+			// The end tangents are the directions of the first and last leg of the control polygons. Reading the control points
+			// instead of the hodographs keeps the shared curves unmodified, which several threads read at once.
+			const auto& startPoints = spline.getCurve(i).getCoefficients();
+			const auto& endPoints = spline.getCurve(j - 1).getCoefficients();
+			const f32vec2 startTangent = normalizeOr(startPoints[1] - startPoints[0], estimateStartTangent(samples.data(), samples.size()));
+			const f32vec2 endTangent = normalizeOr(endPoints[endPoints.size() - 2] - endPoints.back(), estimateEndTangent(samples.data(), samples.size()));
+			CubicFit fit = fitCubic(samples.data(), samples.size(), startTangent, endTangent);
+			if(fit.maxSquaredError > squaredTolerance)
+			{
+				break;
+			}
+			bestFit = std::move(fit);
+			bestEnd = j;
+		}
+
+		if(bestEnd - i > 1)
+		{
+			result.curves.emplace_back(bestFit.controlPoints);
+			result.statistics.nRemovedCurves += static_cast<uint32>(bestEnd - i - 1);
+			result.statistics.maxDeviation = std::max(result.statistics.maxDeviation, std::sqrt(bestFit.maxSquaredError));
+		}
+		else
+		{
+			result.curves.push_back(spline.getCurve(i));
+		}
+		i = bestEnd;
+	}
+	return result;
+}
+
+/// <summary>
+/// A row of a tridiagonal system: a * x[i - 1] + b * x[i] + c * x[i + 1].
+/// </summary>
+struct TridiagonalRow
+{
+	float32 a;
+
+	float32 b;
+
+	float32 c;
+};
+
+/// <summary>
+/// Solves a tridiagonal system with the Thomas algorithm. x holds the right-hand side on input and the solution on output.
+/// The rows are generated on demand, so only cPrime needs additional memory.
+/// </summary>
+template<class V, class RowFunction>
+void solveTridiagonal(std::vector<V>& x, RowFunction row, std::vector<float32>& cPrime)
+{
+	const size_t n = x.size();
+	cPrime.resize(n);
+	TridiagonalRow r = row(0);
+	cPrime[0] = r.c / r.b;
+	x[0] = x[0] / r.b;
+	for(size_t i = 1; i < n; i++)
+	{
+		r = row(i);
+		const float32 m = 1.0f / (r.b - r.a * cPrime[i - 1]);
+		cPrime[i] = r.c * m;
+		x[i] = (x[i] - r.a * x[i - 1]) * m;
+	}
+	for(size_t i = n - 1; i > 0; i--)
+	{
+		x[i - 1] = x[i - 1] - cPrime[i - 1] * x[i];
+	}
+}
+}
+
+ const BezierCurve<f32vec2>& BezierSpline::const_iterator::operator*() const
+{
+	return m_table->chunks[m_chunkIdx]->curves[m_curveIdx];
+}
+
+ const BezierCurve<f32vec2>* BezierSpline::const_iterator::operator->() const
+{
+	return &**this;
+}
+
+ BezierSpline::const_iterator& BezierSpline::const_iterator::operator++()
+{
+	// Chunks are never empty, so the next curve is in this or the next chunk.
+	if(++m_curveIdx == m_table->chunks[m_chunkIdx]->curves.size())
+	{
+		m_chunkIdx++;
+		m_curveIdx = 0;
+	}
+	return *this;
+}
+
+ bool BezierSpline::const_iterator::operator==(const const_iterator& other) const
+{
+	return m_table == other.m_table && m_chunkIdx == other.m_chunkIdx && m_curveIdx == other.m_curveIdx;
+}
+
+ bool BezierSpline::const_iterator::operator!=(const const_iterator& other) const
+{
+	return !(*this == other);
+}
+
+ BezierSpline::const_iterator::const_iterator(const ChunkTable* table, size_t chunkIdx)
+	: m_table(table)
+	, m_chunkIdx(chunkIdx)
+	, m_curveIdx(0)
+{
+}
+
  BezierSpline::BezierSpline()
+	: m_table(std::make_shared<ChunkTable>())
 {
 	std::vector<f32vec2> controlPoints = {
 		f32vec2(-0.6f, -0.5f),
@@ -9,19 +166,355 @@ namespace cogra::gmca
 		f32vec2(0.3f, 0.6f),
 		f32vec2(0.7f, 0.2f),
 	};
-	m_curves.emplace_back(controlPoints);
+	addCurve(BezierCurve<f32vec2>(controlPoints));
+}
+
+ uint32 BezierSpline::getNumberOfCurves() const
+{
+	return m_table->chunkEnds.empty() ? 0 : m_table->chunkEnds.back();
+}
+
+ const BezierCurve<f32vec2>& BezierSpline::getCurve(uint32 curveIdx) const
+{
+	const auto location = locate(curveIdx);
+	return m_table->chunks[location.first]->curves[location.second];
+}
+
+ BezierSpline::const_iterator BezierSpline::begin() const
+{
+	return const_iterator(m_table.get(), 0);
+}
+
+ BezierSpline::const_iterator BezierSpline::end() const
+{
+	return const_iterator(m_table.get(), m_table->chunks.size());
+}
+
+ void BezierSpline::setCurve(uint32 curveIdx, const BezierCurve<f32vec2>& curve)
+{
+	editCurve(curveIdx, [&curve](BezierCurve<f32vec2>& c) { c = curve; });
+}
+
+ void BezierSpline::insertCurve(uint32 curveIdx, const BezierCurve<f32vec2>& curve)
+{
+	if(curveIdx == getNumberOfCurves())
+	{
+		addCurve(curve);
+		return;
+	}
+	const auto location = locate(curveIdx);
+	Chunk& chunk = getMutableChunk(location.first);
+	auto& curves = chunk.curves;
+	curves.insert(curves.begin() + location.second, curve);
+	curves[location.second].updateBoundingBox();
+	if(curves.size() >= 2 * ChunkSize)
+	{
+		auto& chunks = m_table->chunks;
+		auto secondHalf = std::make_shared<Chunk>();
+		secondHalf->curves.assign(curves.begin() + ChunkSize, curves.end());
+		curves.erase(curves.begin() + ChunkSize, curves.end());
+		updateBoundingBox(*secondHalf);
+		chunks.insert(chunks.begin() + location.first + 1, std::move(secondHalf));
+		m_table->chunkEnds.insert(m_table->chunkEnds.begin() + location.first, 0);
+	}
+	updateBoundingBox(chunk);
+	updateChunkEnds(location.first);
+}
+
+ void BezierSpline::eraseCurve(uint32 curveIdx)
+{
+	const auto location = locate(curveIdx);
+	Chunk& chunk = getMutableChunk(location.first);
+	auto& curves = chunk.curves;
+	curves.erase(curves.begin() + location.second);
+	updateBoundingBox(chunk);
+	if(curves.empty())
+	{
+		m_table->chunks.erase(m_table->chunks.begin() + location.first);
+		m_table->chunkEnds.erase(m_table->chunkEnds.begin() + location.first);
+	}
+	updateChunkEnds(location.first);
+}
+
+ void BezierSpline::addCurve(const BezierCurve<f32vec2>& curve)
+{
+	ChunkTable& table = getMutableTable();
+	if(table.chunks.empty() || table.chunks.back()->curves.size() >= ChunkSize)
+	{
+		table.chunks.push_back(std::make_shared<Chunk>());
+		table.chunks.back()->curves.reserve(ChunkSize);
+		table.chunkEnds.push_back(getNumberOfCurves());
+	}
+	Chunk& chunk = getMutableChunk(table.chunks.size() - 1);
+	chunk.curves.push_back(curve);
+	chunk.boundingBox.extend(chunk.curves.back().getBoundingBox());
+	table.chunkEnds.back()++;
+}
+
+ void BezierSpline::setCurves(std::vector<BezierCurve<f32vec2>> curves)
+{
+	auto table = std::make_shared<ChunkTable>();
+	table->chunks.reserve((curves.size() + ChunkSize - 1) / ChunkSize);
+	table->chunkEnds.reserve(table->chunks.capacity());
+	for(auto& curve : curves)
+	{
+		appendCurve(*table, std::move(curve));
+	}
+	m_table = std::move(table);
+}
+
+ void BezierSpline::clear()
+{
+	m_table = std::make_shared<ChunkTable>();
+}
+
+ BoundingBox<f32vec2> BezierSpline::getBoundingBox() const
+{
+	BoundingBox<f32vec2> box;
+	for(const auto& chunk : m_table->chunks)
+	{
+		box.extend(chunk->boundingBox);
+	}
+	return box;
+}
+
+ void BezierSpline::findCurves(const BoundingBox<f32vec2>& region, std::vector<uint32>& curveIndices) const
+{
+	uint32 first = 0;
+	for(size_t i = 0; i < m_table->chunks.size(); i++)
+	{
+		const Chunk& chunk = *m_table->chunks[i];
+		if(chunk.boundingBox.overlaps(region))
+		{
+			for(uint32 j = 0; j < chunk.curves.size(); j++)
+			{
+				if(chunk.curves[j].getBoundingBox().overlaps(region))
+				{
+					curveIndices.push_back(first + j);
+				}
+			}
+		}
+		first = m_table->chunkEnds[i];
+	}
 }
 
  void BezierSpline::subdivide(uint32 curveIdx)
 {
-	auto result = m_curves[curveIdx].subdivide();
-	m_curves[curveIdx] = result.first;
-	m_curves.push_back(result.second);
+	auto result = getCurve(curveIdx).subdivide();
+	setCurve(curveIdx, result.first);
+	insertCurve(curveIdx + 1, result.second);
 }
 
- uint32 BezierSpline::getNumberOfCurves() const
+ void BezierSpline::trim(uint32 curveIdx, float32 a, float32 b)
+{
+	setCurve(curveIdx, getCurve(curveIdx).extract(a, b));
+}
+
+ SimplificationResult BezierSpline::simplify(float32 tolerance)
+{
+	std::vector<std::pair<uint32, uint32>> runs;
+	const BezierCurve<f32vec2>* previous = nullptr;
+	uint32 i = 0;
+	for(const auto& curve : *this)
+	{
+		if(!previous || previous->getCoefficients().back() != curve.getCoefficients().front())
+		{
+			runs.emplace_back(i, i);
+		}
+		runs.back().second = ++i;
+		previous = &curve;
+	}
+
+	std::vector<RunResult> runResults(runs.size());
+	const size_t nThreads = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), runs.size()));
+	std::vector<std::future<void>> tasks;
+	for(size_t t = 0; t < nThreads; t++)
+	{
+		tasks.push_back(std::async(std::launch::async, [&, t]
+		{
+			for(size_t r = t; r < runs.size(); r += nThreads)
+			{
+				runResults[r] = simplifyRun(*this, runs[r].first, runs[r].second, tolerance);
+			}
+		}));
+	}
+	for(auto& task : tasks)
+	{
+		task.get();
+	}
+
+	// Move the merged curves of each run straight into the chunks of the new table and release the run right away.
+	SimplificationResult result;
+	auto table = std::make_shared<ChunkTable>();
+	for(auto& runResult : runResults)
+	{
+		for(auto& curve : runResult.curves)
+		{
+			appendCurve(*table, std::move(curve));
+		}
+		runResult.curves = std::vector<BezierCurve<f32vec2>>();
+		result.nRemovedCurves += runResult.statistics.nRemovedCurves;
+		result.maxDeviation = std::max(result.maxDeviation, runResult.statistics.maxDeviation);
+	}
+	m_table = std::move(table);
+	return result;
+}
+
+ void BezierSpline::interpolate(const std::vector<f32vec2>& points, EndCondition endCondition,
+	const f32vec2& startDerivative, const f32vec2& endDerivative)
+{
+	const bool isPeriodic = endCondition == EndCondition::Periodic;
+	const size_t n = points.size();
+	if(n < (isPeriodic ? 3u : 2u))
+	{
+		throw cogra::exceptions::RuntimeError("Not enough points to interpolate");
+	}
+
+	// Derivatives d[i] at the points satisfy d[i - 1] + 4 d[i] + d[i + 1] = 3 (p[i + 1] - p[i - 1]).
+	std::vector<f32vec2> d(n);
+	std::vector<float32> cPrime;
+	if(isPeriodic)
+	{
+		for(size_t i = 0; i < n; i++)
+		{
+			d[i] = 3.0f * (points[(i + 1) % n] - points[(i + n - 1) % n]);
+		}
+
+		// Sherman-Morrison: the cyclic matrix is a tridiagonal one plus u * v^T
+		// with u = (gamma, 0, ..., 0, 1) and v = (1, 0, ..., 0, 1 / gamma).
+		const float32 gamma = -4.0f;
+		const auto row = [n, gamma](size_t i)
+		{
+			TridiagonalRow r = { 1.0f, 4.0f, 1.0f };
+			if(i == 0)
+			{
+				r.a = 0.0f;
+				r.b -= gamma;
+			}
+			if(i == n - 1)
+			{
+				r.c = 0.0f;
+				r.b -= 1.0f / gamma;
+			}
+			return r;
+		};
+		solveTridiagonal(d, row, cPrime);
+		std::vector<float32> z(n, 0.0f);
+		z[0] = gamma;
+		z[n - 1] = 1.0f;
+		solveTridiagonal(z, row, cPrime);
+		const f32vec2 factor = (d[0] + d[n - 1] / gamma) / (1.0f + z[0] + z[n - 1] / gamma);
+		for(size_t i = 0; i < n; i++)
+		{
+			d[i] -= z[i] * factor;
+		}
+	}
+	else
+	{
+		const bool isClamped = endCondition == EndCondition::Clamped;
+		for(size_t i = 1; i + 1 < n; i++)
+		{
+			d[i] = 3.0f * (points[i + 1] - points[i - 1]);
+		}
+		d[0] = isClamped ? startDerivative : 3.0f * (points[1] - points[0]);
+		d[n - 1] = isClamped ? endDerivative : 3.0f * (points[n - 1] - points[n - 2]);
+		solveTridiagonal(d, [n, isClamped](size_t i)
+		{
+			if(i == 0)
+			{
+				return isClamped ? TridiagonalRow{ 0.0f, 1.0f, 0.0f } : TridiagonalRow{ 0.0f, 2.0f, 1.0f };
+			}
+			if(i == n - 1)
+			{
+				return isClamped ? TridiagonalRow{ 0.0f, 1.0f, 0.0f } : TridiagonalRow{ 1.0f, 2.0f, 0.0f };
+			}
+			return TridiagonalRow{ 1.0f, 4.0f, 1.0f };
+		}, cPrime);
+	}
+
+	// Release the old curves first and emit the new ones straight into the chunks.
+	const size_t nCurves = isPeriodic ? n : n - 1;
+	m_table = std::make_shared<ChunkTable>();
+	m_table->chunks.reserve((nCurves + ChunkSize - 1) / ChunkSize);
+	m_table->chunkEnds.reserve(m_table->chunks.capacity());
+	std::vector<f32vec2> controlPoints(4);
+	for(size_t i = 0; i < nCurves; i++)
+	{
+		const size_t next = (i + 1) % n;
+		controlPoints[0] = points[i];
+		controlPoints[1] = points[i] + d[i] / 3.0f;
+		controlPoints[2] = points[next] - d[next] / 3.0f;
+		controlPoints[3] = points[next];
+		appendCurve(*m_table, BezierCurve<f32vec2>(controlPoints));
+	}
+}
+
+ std::pair<size_t, size_t> BezierSpline::locate(uint32 curveIdx) const
+{
+	const auto& chunkEnds = m_table->chunkEnds;
+	const size_t chunkIdx = std::upper_bound(chunkEnds.begin(), chunkEnds.end(), curveIdx) - chunkEnds.begin();
+	if(chunkIdx == chunkEnds.size())
+	{
+		throw cogra::exceptions::RuntimeError("Curve index out of range");
+	}
+	return std::make_pair(chunkIdx, curveIdx - (chunkIdx == 0 ? 0 : chunkEnds[chunkIdx - 1]));
+}
+
+ BezierSpline::ChunkTable& BezierSpline::getMutableTable()
+{
+	// Other splines only release their references concurrently, so a count of one cannot grow behind our back.
+	// The fence orders the reads of the last releasing thread before the following writes.
+	if(m_table.use_count() > 1)
+	{
+		m_table = std::make_shared<ChunkTable>(*m_table);
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return *m_table;
+}
+
+ BezierSpline::Chunk& BezierSpline::getMutableChunk(size_t chunkIdx)
+{
+	auto& chunk = getMutableTable().chunks[chunkIdx];
+	if(chunk.use_count() > 1)
+	{
+		chunk = std::make_shared<Chunk>(*chunk);
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return *chunk;
+}
+
+ void BezierSpline::appendCurve(ChunkTable& table, BezierCurve<f32vec2>&& curve)
+{
+	if(table.chunks.empty() || table.chunks.back()->curves.size() >= ChunkSize)
+	{
+		table.chunks.push_back(std::make_shared<Chunk>());
+		table.chunks.back()->curves.reserve(ChunkSize);
+		table.chunkEnds.push_back(table.chunkEnds.empty() ? 0 : table.chunkEnds.back());
+	}
+	Chunk& chunk = *table.chunks.back();
+	chunk.curves.push_back(std::move(curve));
+	chunk.boundingBox.extend(chunk.curves.back().getBoundingBox());
+	table.chunkEnds.back()++;
+}
+
+ void BezierSpline::updateBoundingBox(Chunk& chunk)
+{
+	chunk.boundingBox = BoundingBox<f32vec2>();
+	for(const auto& curve : chunk.curves)
+	{
+		chunk.boundingBox.extend(curve.getBoundingBox());
+	}
+}
+
+ void BezierSpline::updateChunkEnds(size_t firstChunkIdx)
 {
-	return static_cast<uint32>(m_curves.size());
+	auto& table = *m_table;
+	uint32 end = (firstChunkIdx == 0) ? 0 : table.chunkEnds[firstChunkIdx - 1];
+	for(size_t i = firstChunkIdx; i < table.chunks.size(); i++)
+	{
+		end += static_cast<uint32>(table.chunks[i]->curves.size());
+		table.chunkEnds[i] = end;
+	}
 }
 
 }
\ No newline at end of file
@@ -1,18 +1,220 @@
 #pragma once
 #include <cogra/types.h>
+#include <memory>
+#include <utility>
 #include <vector>
 #include "BezierCurve.h"
 namespace cogra::gmca
 {
+/// <summary>
+/// Outcome of BezierSpline::simplify.
+/// </summary>
+struct SimplificationResult
+{
+	uint32 nRemovedCurves = 0;
+
+	//! Largest distance between a sample of the merged curves and the curve that replaced them.
+	float32 maxDeviation = 0.0f;
+};
+
+/// <summary>
+/// Boundary conditions of an interpolating cubic spline.
+/// </summary>
+enum class EndCondition : int32
+{
+	//! Vanishing second derivatives at both ends.
+	Natural,
+
+	//! Prescribed first derivatives at both ends.
+	Clamped,
+
+	//! Closed curve that is C2 at the first point as well.
+	Periodic
+};
+
+/// <summary>
+/// A sequence of Bezier curves.
+///
+/// The curves are stored in chunks of about ChunkSize curves that are shared between copies of the spline and
+/// copied on the first write, so copying a spline is O(1) and editing a curve copies one chunk and the chunk table.
+/// Copies are immutable snapshots: they are not affected by later edits of the original and may be read from other
+/// threads without locks, because stored curves always have their cached data computed and are never written again.
+/// Edits of a spline object itself must not overlap with other accesses to that object.
+/// </summary>
 class BezierSpline
 {
+	struct Chunk;
+
+	struct ChunkTable;
+
 public:
+	//! Number of curves a chunk is filled with. Chunks that grow to twice the size by insertions are split.
+	static constexpr size_t ChunkSize = 64;
+
+	/// <summary>
+	/// Iterates the curves in order.
+	/// </summary>
+	class const_iterator
+	{
+	public:
+		const BezierCurve<f32vec2>& operator*() const;
+
+		const BezierCurve<f32vec2>* operator->() const;
+
+		const_iterator& operator++();
+
+		bool operator==(const const_iterator& other) const;
+
+		bool operator!=(const const_iterator& other) const;
+
+	private:
+		friend class BezierSpline;
+
+		const_iterator(const ChunkTable* table, size_t chunkIdx);
+
+		const ChunkTable*   m_table;
+
+		size_t              m_chunkIdx;
+
+		size_t              m_curveIdx;
+	};
+
 	BezierSpline();
 
-	void subdivide(uint32 curveIdx);	
+	/// <summary>
+	/// Creates a snapshot in O(1). Moves are copies as well, so a spline is never left without chunk table.
+	/// </summary>
+	BezierSpline(const BezierSpline& other) = default;
+
+	BezierSpline& operator=(const BezierSpline& other) = default;
 
 	uint32 getNumberOfCurves() const;
 
-	std::vector<BezierCurve<f32vec2>> m_curves;
+	const BezierCurve<f32vec2>& getCurve(uint32 curveIdx) const;
+
+	const_iterator begin() const;
+
+	const_iterator end() const;
+
+	/// <summary>
+	/// Lets edit modify a curve in place, e.g., its control points. Copies the chunk of the curve first if it is shared.
+	/// The bounding box of the curve is updated afterwards.
+	/// </summary>
+	/// <param name="curveIdx">The curve to edit.</param>
+	/// <param name="edit">Called with a BezierCurve&lt;f32vec2&gt;&amp;.</param>
+	template<class Edit>
+	void editCurve(uint32 curveIdx, Edit edit)
+	{
+		const auto location = locate(curveIdx);
+		Chunk& chunk = getMutableChunk(location.first);
+		BezierCurve<f32vec2>& curve = chunk.curves[location.second];
+		edit(curve);
+		curve.updateBoundingBox();
+		updateBoundingBox(chunk);
+	}
+
+	void setCurve(uint32 curveIdx, const BezierCurve<f32vec2>& curve);
+
+	void insertCurve(uint32 curveIdx, const BezierCurve<f32vec2>& curve);
+
+	void eraseCurve(uint32 curveIdx);
+
+	void addCurve(const BezierCurve<f32vec2>& curve);
+
+	/// <summary>
+	/// Replaces all curves.
+	/// </summary>
+	void setCurves(std::vector<BezierCurve<f32vec2>> curves);
+
+	void clear();
+
+	/// <summary>
+	/// Returns the smallest axis aligned box that contains all curves. Costs O(n / ChunkSize), because
+	/// every chunk keeps the union of the exact boxes of its curves up to date.
+	/// </summary>
+	BoundingBox<f32vec2> getBoundingBox() const;
+
+	/// <summary>
+	/// Appends the indices of all curves whose exact bounding box overlaps the region, in increasing order.
+	/// Chunks whose box does not overlap the region are skipped as a whole.
+	/// </summary>
+	void findCurves(const BoundingBox<f32vec2>& region, std::vector<uint32>& curveIndices) const;
+
+	/// <summary>
+	/// Splits a curve at its parameter midpoint. The second half is inserted right after the first one.
+	/// </summary>
+	void subdivide(uint32 curveIdx);	
+
+	/// <summary>
+	/// Replaces a curve by its part on the parameter interval [a, b].
+	/// </summary>
+	void trim(uint32 curveIdx, float32 a, float32 b);
+
+	/// <summary>
+	/// Merges runs of adjacent curves into single cubic curves, as long as a least-squares fit deviates
+	/// at most tolerance from the samples of the merged curves.
+	///
+	/// Curves are adjacent if the last control point of one equals the first control point of its successor.
+	/// Runs of adjacent curves are independent of each other and are simplified in parallel.
+	/// Within a run, curves are merged greedily from front to back.
+	/// </summary>
+	SimplificationResult simplify(float32 tolerance);
+
+	/// <summary>
+	/// Replaces the curves by a C2 continuous cubic spline through the points with uniform parameterization.
+	///
+	/// The first derivatives at the points are the solution of a tridiagonal system, which is solved with
+	/// the Thomas algorithm (and Sherman-Morrison for periodic splines) in O(n) time and memory.
+	/// </summary>
+	/// <param name="points">The points to interpolate. At least two, or three for periodic splines.</param>
+	/// <param name="endCondition">The boundary conditions.</param>
+	/// <param name="startDerivative">First derivative at the first point. Only used for clamped splines.</param>
+	/// <param name="endDerivative">First derivative at the last point. Only used for clamped splines.</param>
+	void interpolate(const std::vector<f32vec2>& points, EndCondition endCondition,
+		const f32vec2& startDerivative = f32vec2(0.0f, 0.0f), const f32vec2& endDerivative = f32vec2(0.0f, 0.0f));
+
+private:
+	struct Chunk
+	{
+		std::vector<BezierCurve<f32vec2>> curves;
+
+		//! Union of the bounding boxes of the curves.
+		BoundingBox<f32vec2> boundingBox;
+	};
+
+	struct ChunkTable
+	{
+		std::vector<std::shared_ptr<Chunk>> chunks;
+
+		//! Entry i is the number of curves in the chunks 0, ..., i.
+		std::vector<uint32> chunkEnds;
+	};
+
+	/// <summary>
+	/// Finds the chunk of a curve and the index of the curve within the chunk.
+	/// </summary>
+	std::pair<size_t, size_t> locate(uint32 curveIdx) const;
+
+	/// <summary>
+	/// Returns the chunk table, after copying it if it is shared with another spline.
+	/// </summary>
+	ChunkTable& getMutableTable();
+
+	/// <summary>
+	/// Returns a chunk, after copying it and the table if they are shared with another spline.
+	/// </summary>
+	Chunk& getMutableChunk(size_t chunkIdx);
+
+	/// <summary>
+	/// Appends a curve to a table that is not shared yet, e.g., while it is being built.
+	/// Fills the last chunk up to ChunkSize curves before starting a new one.
+	/// </summary>
+	static void appendCurve(ChunkTable& table, BezierCurve<f32vec2>&& curve);
+
+	static void updateBoundingBox(Chunk& chunk);
+
+	void updateChunkEnds(size_t firstChunkIdx);
+
+	std::shared_ptr<ChunkTable> m_table;
 };
 }
\ No newline at end of file
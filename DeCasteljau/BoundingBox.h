@@ -0,0 +1,55 @@
+#pragma once
+#include <algorithm>
+#include <limits>
+namespace cogra::gmca
+{
+/// <summary>
+/// An axis aligned box. A default constructed box is empty and contains no point.
+/// </summary>
+template<class T>
+struct BoundingBox
+{
+    typedef T vector_type;
+    typedef typename T::value_type value_type;
+
+    vector_type min = vector_type(std::numeric_limits<value_type>::max());
+
+    vector_type max = vector_type(std::numeric_limits<value_type>::lowest());
+
+    bool isEmpty() const
+    {
+        return min.x > max.x || min.y > max.y;
+    }
+
+    void extend(const vector_type& p)
+    {
+        min.x = std::min(min.x, p.x);
+        min.y = std::min(min.y, p.y);
+        max.x = std::max(max.x, p.x);
+        max.y = std::max(max.y, p.y);
+    }
+
+    void extend(const BoundingBox& other)
+    {
+        min.x = std::min(min.x, other.min.x);
+        min.y = std::min(min.y, other.min.y);
+        max.x = std::max(max.x, other.max.x);
+        max.y = std::max(max.y, other.max.y);
+    }
+
+    bool overlaps(const BoundingBox& other) const
+    {
+        return min.x <= other.max.x && other.min.x <= max.x && min.y <= other.max.y && other.min.y <= max.y;
+    }
+
+    bool contains(const vector_type& p) const
+    {
+        return min.x <= p.x && p.x <= max.x && min.y <= p.y && p.y <= max.y;
+    }
+
+    value_type getArea() const
+    {
+        return isEmpty() ? value_type(0) : (max.x - min.x) * (max.y - min.y);
+    }
+};
+}
@@ -0,0 +1,158 @@
+#include "CubicFitting.h"
+#include <algorithm>
+#include <cmath>
+namespace cogra::gmca
+{
+namespace
+{
+//! Number of neighbors that are averaged when estimating tangents.
+constexpr size_t TangentNeighborhood = 3;
+
+float32 dot(const f32vec2& a, const f32vec2& b)
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+f32vec2 normalizeOr(const f32vec2& v, const f32vec2& fallback)
+{
+    const float32 l = std::sqrt(dot(v, v));
+    return (l > 0.0f) ? v / l : fallback;
+}
+
+std::vector<float32> parameterizeByChordLength(const f32vec2* points, size_t nPoints)
+{
+    std::vector<float32> u(nPoints, 0.0f);
+    for(size_t i = 1; i < nPoints; i++)
+    {
+        const f32vec2 d = points[i] - points[i - 1];
+        u[i] = u[i - 1] + std::sqrt(dot(d, d));
+    }
+    const float32 totalLength = u.back();
+    for(size_t i = 1; i < nPoints; i++)
+    {
+        u[i] = (totalLength > 0.0f) ? u[i] / totalLength : static_cast<float32>(i) / static_cast<float32>(nPoints - 1);
+    }
+    return u;
+}
+
+/// <summary>
+/// Solves for the distances of the inner control points from the end points in the least-squares sense.
+/// </summary>
+std::vector<f32vec2> fitControlPoints(const f32vec2* points, size_t nPoints, const std::vector<float32>& u,
+    const f32vec2& startTangent, const f32vec2& endTangent)
+{
+    const f32vec2 p0 = points[0];
+    const f32vec2 p3 = points[nPoints - 1];
+
+    float32 c00 = 0.0f, c01 = 0.0f, c11 = 0.0f;
+    float32 x0 = 0.0f, x1 = 0.0f;
+    for(size_t i = 0; i < nPoints; i++)
+    {
+        const float32 t = u[i];
+        const float32 s = 1.0f - t;
+        const float32 b0 = s * s * s;
+        const float32 b1 = 3.0f * t * s * s;
+        const float32 b2 = 3.0f * t * t * s;
+        const float32 b3 = t * t * t;
+        const f32vec2 a0 = b1 * startTangent;
+        const f32vec2 a1 = b2 * endTangent;
+        c00 += dot(a0, a0);
+        c01 += dot(a0, a1);
+        c11 += dot(a1, a1);
+        const f32vec2 r = points[i] - ((b0 + b1) * p0 + (b2 + b3) * p3);
+        x0 += dot(a0, r);
+        x1 += dot(a1, r);
+    }
+
+    const float32 chordLength = std::sqrt(dot(p3 - p0, p3 - p0));
+    const float32 determinant = c00 * c11 - c01 * c01;
+    float32 alpha0 = 0.0f;
+    float32 alpha1 = 0.0f;
+    if(std::abs(determinant) > 1e-12f * std::max(c00 * c11, 1e-30f))
+    {
+        alpha0 = (x0 * c11 - x1 * c01) / determinant;
+        alpha1 = (c00 * x1 - c01 * x0) / determinant;
+    }
+
+    // Non-positive distances would flip the tangents and tiny ones lose their direction to rounding.
+    // Both would break tangent continuity at the joins.
+    // Fall back to Wu/Barsky's heuristic in this case.
+    const float32 epsilon = 1e-3f * chordLength;
+    if(!(alpha0 > epsilon) || !(alpha1 > epsilon))
+    {
+        alpha0 = alpha1 = chordLength / 3.0f;
+    }
+
+    return { p0, p0 + alpha0 * startTangent, p3 + alpha1 * endTangent, p3 };
+}
+
+/// <summary>
+/// One Newton step on |Q(u) - P|^2 for each parameter.
+/// </summary>
+void reparameterize(const BezierCurve<f32vec2>& curve, const f32vec2* points, size_t nPoints, std::vector<float32>& u)
+{
+    const auto& firstHodograph = curve.getFirstHodograph();
+    const auto& secondHodograph = curve.getSecondHodograph();
+    for(size_t i = 1; i + 1 < nPoints; i++)
+    {
+        const f32vec2 d = curve.evaluate(u[i]) - points[i];
+        const f32vec2 d1 = BezierCurve<f32vec2>::evaluate(firstHodograph, u[i]);
+        const f32vec2 d2 = BezierCurve<f32vec2>::evaluate(secondHodograph, u[i]);
+        const float32 numerator = dot(d, d1);
+        const float32 denominator = dot(d1, d1) + dot(d, d2);
+        if(denominator != 0.0f)
+        {
+            u[i] = std::clamp(u[i] - numerator / denominator, 0.0f, 1.0f);
+        }
+    }
+}
+
+void computeError(const BezierCurve<f32vec2>& curve, const f32vec2* points, size_t nPoints, const std::vector<float32>& u, CubicFit& fit)
+{
+    fit.maxSquaredError = 0.0f;
+    fit.maxErrorIndex = 0;
+    for(size_t i = 1; i + 1 < nPoints; i++)
+    {
+        const f32vec2 d = curve.evaluate(u[i]) - points[i];
+        const float32 squaredError = dot(d, d);
+        if(squaredError > fit.maxSquaredError)
+        {
+            fit.maxSquaredError = squaredError;
+            fit.maxErrorIndex = i;
+        }
+    }
+}
+}
+
+CubicFit fitCubic(const f32vec2* points, size_t nPoints, const f32vec2& startTangent, const f32vec2& endTangent,
+    uint32 nReparameterizations)
+{
+    CubicFit fit;
+    if(nPoints < 2)
+    {
+        throw cogra::exceptions::RuntimeError("fitCubic requires at least two points");
+    }
+
+    std::vector<float32> u = parameterizeByChordLength(points, nPoints);
+    fit.controlPoints = fitControlPoints(points, nPoints, u, startTangent, endTangent);
+    for(uint32 i = 0; i < nReparameterizations; i++)
+    {
+        reparameterize(BezierCurve<f32vec2>(fit.controlPoints), points, nPoints, u);
+        fit.controlPoints = fitControlPoints(points, nPoints, u, startTangent, endTangent);
+    }
+    computeError(BezierCurve<f32vec2>(fit.controlPoints), points, nPoints, u, fit);
+    return fit;
+}
+
+f32vec2 estimateStartTangent(const f32vec2* points, size_t nPoints)
+{
+    const size_t k = std::min(TangentNeighborhood, nPoints - 1);
+    return normalizeOr(points[k] - points[0], normalizeOr(points[nPoints - 1] - points[0], f32vec2(1.0f, 0.0f)));
+}
+
+f32vec2 estimateEndTangent(const f32vec2* points, size_t nPoints)
+{
+    const size_t k = std::min(TangentNeighborhood, nPoints - 1);
+    return normalizeOr(points[nPoints - 1 - k] - points[nPoints - 1], normalizeOr(points[0] - points[nPoints - 1], f32vec2(-1.0f, 0.0f)));
+}
+}
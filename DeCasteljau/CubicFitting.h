@@ -0,0 +1,47 @@
+#pragma once
+#include <cogra/types.h>
+#include <vector>
+#include "BezierCurve.h"
+namespace cogra::gmca
+{
+/// <summary>
+/// Result of a least-squares fit of a cubic Bezier curve to a sequence of points.
+/// </summary>
+struct CubicFit
+{
+    std::vector<f32vec2>    controlPoints;
+
+    //! The largest squared distance between a point and its parameter on the curve.
+    float32                 maxSquaredError = 0.0f;
+
+    //! Index of the point with the largest error.
+    size_t                  maxErrorIndex = 0;
+};
+
+/// <summary>
+/// Fits a cubic Bezier curve to points[0], ..., points[nPoints - 1] following Schneider's algorithm
+/// (An Algorithm for Automatically Fitting Digitized Curves, Graphics Gems, 1990).
+///
+/// The end points of the curve interpolate the first and last point. The directions of the inner
+/// control points are fixed by the tangents, only their distances are chosen by least squares.
+/// The points are parameterized by chord length and the parameters are improved by Newton iterations.
+/// </summary>
+/// <param name="points">The points. At least two.</param>
+/// <param name="nPoints">Number of points.</param>
+/// <param name="startTangent">Unit tangent at the first point pointing into the curve.</param>
+/// <param name="endTangent">Unit tangent at the last point pointing into the curve, i.e. backwards.</param>
+/// <param name="nReparameterizations">Number of Newton iterations for the parameters.</param>
+CubicFit fitCubic(const f32vec2* points, size_t nPoints, const f32vec2& startTangent, const f32vec2& endTangent,
+    uint32 nReparameterizations = 3);
+
+/// <summary>
+/// Estimates the unit tangent at points[0] pointing towards points[1], ..., points[nPoints - 1].
+/// Averages over a few neighbors to be robust against noise.
+/// </summary>
+f32vec2 estimateStartTangent(const f32vec2* points, size_t nPoints);
+
+/// <summary>
+/// Estimates the unit tangent at points[nPoints - 1] pointing backwards along the points.
+/// </summary>
+f32vec2 estimateEndTangent(const f32vec2* points, size_t nPoints);
+}
@@ -0,0 +1,93 @@
+#include "CurveTessellator.h"
+#include <utility>
+namespace cogra::gmca
+{
+CurveTessellator::CurveTessellator(std::function<void()> onResult)
+    : m_onResult(std::move(onResult))
+    , m_generation(0)
+    , m_hasPendingJob(false)
+    , m_hasFinishedResult(false)
+    , m_isShuttingDown(false)
+    , m_worker(&CurveTessellator::run, this)
+{
+}
+
+CurveTessellator::~CurveTessellator()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isShuttingDown = true;
+        m_generation++;
+    }
+    m_condition.notify_one();
+    m_worker.join();
+}
+
+void CurveTessellator::submit(const BezierSpline& spline, uint32 nSamples)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingJob.spline = spline;
+        m_pendingJob.nSamples = nSamples;
+        m_hasPendingJob = true;
+        m_generation++;
+    }
+    m_condition.notify_one();
+}
+
+bool CurveTessellator::fetchResult(std::vector<std::vector<f32vec2>>& sampledCurves)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(!m_hasFinishedResult)
+    {
+        return false;
+    }
+    std::swap(sampledCurves, m_finishedBuffer);
+    m_hasFinishedResult = false;
+    return true;
+}
+
+void CurveTessellator::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(true)
+    {
+        m_condition.wait(lock, [this] { return m_hasPendingJob || m_isShuttingDown; });
+        if(m_isShuttingDown)
+        {
+            return;
+        }
+
+        Job job = std::move(m_pendingJob);
+        m_hasPendingJob = false;
+        const uint64 generation = m_generation;
+        lock.unlock();
+
+        bool isCancelled = false;
+        m_backBuffer.resize(job.spline.getNumberOfCurves());
+        size_t i = 0;
+        for(const auto& curve : job.spline)
+        {
+            if(m_generation != generation)
+            {
+                isCancelled = true;
+                break;
+            }
+            m_backBuffer[i++] = curve.sample(job.nSamples);
+        }
+
+        lock.lock();
+        if(!isCancelled && m_generation == generation)
+        {
+            std::swap(m_backBuffer, m_finishedBuffer);
+            m_hasFinishedResult = true;
+            if(m_onResult)
+            {
+                lock.unlock();
+                m_onResult();
+                lock.lock();
+            }
+        }
+    }
+}
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <cogra/types.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "BezierSpline.h"
+namespace cogra::gmca
+{
+/// <summary>
+/// Samples the curves of a spline on a worker thread.
+///
+/// At most one job is pending at any time. Submitting a new job replaces the pending one and cancels
+/// the job that is currently sampled. The worker writes into a back buffer that is handed to the caller
+/// by fetchResult, so neither input handling nor rendering ever waits on sampling.
+/// </summary>
+class CurveTessellator
+{
+public:
+    /// <summary>
+    /// Starts the worker thread.
+    /// </summary>
+    /// <param name="onResult">Called on the worker thread whenever a result is ready to be fetched. Must be thread safe.</param>
+    explicit CurveTessellator(std::function<void()> onResult = nullptr);
+
+    ~CurveTessellator();
+
+    CurveTessellator(const CurveTessellator&) = delete;
+
+    CurveTessellator& operator=(const CurveTessellator&) = delete;
+
+    /// <summary>
+    /// Schedules sampling of the curves of a spline. Older jobs that did not finish yet are discarded.
+    /// The worker samples a snapshot of the spline, so the spline may be edited right away.
+    /// </summary>
+    /// <param name="spline">The spline to sample.</param>
+    /// <param name="nSamples">Number of sample points per curve.</param>
+    void submit(const BezierSpline& spline, uint32 nSamples);
+
+    /// <summary>
+    /// Swaps the most recent finished result with sampledCurves.
+    /// The previous content of sampledCurves is recycled as back buffer by the worker.
+    /// </summary>
+    /// <returns>true, if a new result was available.</returns>
+    bool fetchResult(std::vector<std::vector<f32vec2>>& sampledCurves);
+
+private:
+    struct Job
+    {
+        BezierSpline                        spline;
+
+        uint32                              nSamples = 0;
+    };
+
+    void run();
+
+    std::function<void()>                   m_onResult;
+
+    std::mutex                              m_mutex;
+
+    std::condition_variable                 m_condition;
+
+    //! Incremented by every submit. A running job whose generation is outdated is cancelled.
+    std::atomic<uint64>                     m_generation;
+
+    Job                                     m_pendingJob;
+
+    bool                                    m_hasPendingJob;
+
+    //! Written by the worker only.
+    std::vector<std::vector<f32vec2>>       m_backBuffer;
+
+    std::vector<std::vector<f32vec2>>       m_finishedBuffer;
+
+    bool                                    m_hasFinishedResult;
+
+    bool                                    m_isShuttingDown;
+
+    std::thread                             m_worker;
+};
+}
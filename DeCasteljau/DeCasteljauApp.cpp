@@ -6,22 +6,33 @@
 #include <glad/glad.h>
 #include <cogra/types.h>
 
+#include <cogra/exceptions/RuntimeError.h>
 #include <cogra/gl/GLSLProgram.h>
 #include <cogra/ui/GLFWApp.h>
 #include <cogra/ui/GLFWWindow.h>
 #include <cogra/graphics/drawable/PolyLineDrawable.h>
 
-#include <cogra/ui/PointDragger.h>
 #include "BezierCurve.h"
 #include "BezierSpline.h"
+#include "BezierCurveBatch.h"
+#include "CurveTessellator.h"
+#include "GPUTimer.h"
+#include "SplineRenderer.h"
+#include "HeadlessExporter.h"
+#include "SplineFitter.h"
+#include "SplineRasterizer.h"
+#include "ProcessMemory.h"
 
 #include <imgui/imgui.h>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sstream>
 #include "BaseApp2D.h"
 
 using cogra::ui::GLFWWindow;
 using cogra::ui::GLFWWindowConfig;
-using cogra::ui::PointDragger;
 using namespace cogra::graphics::drawable;
 
 
@@ -33,6 +44,44 @@ cogra::f32vec2 transformPoint(f32mat3 m, f32vec2 p)
     const auto t = glm::inverse(m) * p3;
     return f32vec2(t.x, t.y);
 }
+
+/// <summary>
+/// Labels like "C0", "C1", ... that are built once and reused in every frame.
+/// </summary>
+class LabelCache
+{
+public:
+    explicit LabelCache(std::string prefix)
+        : m_prefix(std::move(prefix))
+    {
+    }
+
+    const char* get(size_t i)
+    {
+        while(m_labels.size() <= i)
+        {
+            m_labels.push_back(m_prefix + std::to_string(m_labels.size()));
+        }
+        return m_labels[i].c_str();
+    }
+
+private:
+    std::string                 m_prefix;
+
+    std::vector<std::string>    m_labels;
+};
+
+/// <summary>
+/// Replay requested on the command line.
+/// </summary>
+struct ReplayOptions
+{
+    std::string path;
+
+    bool useRecordedTiming = false;
+};
+
+ReplayOptions g_replayOptions;
 }
 
 namespace cogra::gmca
@@ -45,77 +94,183 @@ class DeCasteljauApp : public cogra::ui::BaseApp2D
 public:
     explicit DeCasteljauApp(GLFWwindow* window)
         : BaseApp2D(window)
-        , m_drawCurveProgram("../shaders/drawCurve.vert.glsl", "../shaders/drawCurve.geom.glsl", "../shaders/drawCurve.frag.glsl")
-        , m_drawPointsProgram("../shaders/drawPoints.vert.glsl", "../shaders/drawPoints.geom.glsl", "../shaders/drawPoints.frag.glsl")
-
+        , m_tessellator([]() { glfwPostEmptyEvent(); })
     {        
         updateCurveInfoUI();
         updateCurve();
         GL_SAFE_CALL(glClearColor(1.0f, 1.0f, 1.0f, 1.0f));
         onFramebufferSize(this->getFramebufferWidth(), this->getFramebufferHeight());
+        if(!g_replayOptions.path.empty())
+        {
+            startReplay(g_replayOptions.path, g_replayOptions.useRecordedTiming, true);
+        }
     }
 
     ~DeCasteljauApp() override = default;
 
 private:
 
-    //! The GPU program that draws the curve.
-    cogra::gl::GLSLProgram                                              m_drawCurveProgram;
+    //! Draws curves, control polygons and control points.
+    SplineRenderer                                                      m_splineRenderer;
+
+    std::vector<PolyLineDrawable>                                       m_deCasteljauMeshes;
 
-    //! The GPU program that draws the points
-    cogra::gl::GLSLProgram                                              m_drawPointsProgram;
+    //! Measures the GPU time of drawing curve, control polygon and control points.
+    GPUTimer                                                            m_renderTimer;
 
-    //! The drawable that holds GPU data for drawing the curve.
-    std::vector<PolyLineDrawable>                                       m_lineDrawable;
+    cogra::gmca::BezierSpline                                           m_bezierSpline;
 
-    std::vector<PolyLineDrawable>                                       m_controlNetMesh;
+    //! Samples the spline on a worker thread.
+    CurveTessellator                                                    m_tessellator;
 
-    std::vector<PolyLineDrawable>                                       m_deCasteljauMeshes;
+    //! Front buffer with the sampled curves that are currently uploaded to m_splineRenderer.
+    std::vector<std::vector<f32vec2>>                                   m_sampledCurves;
 
-    PointDragger                                                        m_pointDragger;
+    //! Set by edits. All edits of a frame are coalesced into a single tessellation job.
+    bool                                                                m_isCurveDirty = false;
 
-    cogra::gmca::BezierSpline                                           m_bezierSpline;
+    //! Snapshots of the spline before each edit. They share all unchanged chunks with each other and with m_bezierSpline.
+    std::vector<BezierSpline>                                           m_undoHistory;
+
+    std::vector<BezierSpline>                                           m_redoHistory;
+
+    //! Snapshot taken when a drag starts. Becomes an undo step once a control point actually moves.
+    BezierSpline                                                        m_dragStartSpline;
+
+    //! Control point of the selected curve under the pointer when the drag started, or -1 if the drag hit no control point.
+    int32                                                               m_draggedPointIndex = -1;
+
+    //! Offset from the pointer to the dragged control point, so the point does not jump to the pointer when the drag starts.
+    f32vec2                                                             m_dragOffset = f32vec2(0.0f);
+
+    bool                                                                m_hasDragMoved = false;
 
     //! Data obtained by the user inteface.
     struct UIData
     {
         int32 selectedCurveIndex = 0;
 
-        //! Center of the cruve
-        std::vector<f32vec2>* controlPoints;
-       
-
         std::vector<bool> showDecasteljau;
 
         std::vector<float32> sampleValueDeCasteljau;
 
-        //! Number of samples that is used to sample the curve.
-        int32 nSamples = 64;
+        //! Labels of the control point sliders, the parameter sliders and the de Casteljau checkboxes.
+        LabelCache controlPointLabels = LabelCache("C");
+
+        LabelCache parameterLabels = LabelCache("t");
+
+        LabelCache deCasteljauLabels = LabelCache("D");
 
-        //! The linewidth in pixels that is used to draw the curve.
-        float32 curveLineWidth = 16.0f;
+        //! Filters the curve list by the text of its entries.
+        ImGuiTextFilter curveFilter;
 
-        float32 controlPolygonLineWidth = 10.0f;
+        //! Indices of the curves that pass the filter. Rebuilt when the filter or the number of curves changes,
+        //! and when isCurveFilterDirty is set because the spline was replaced or the degree of a curve changed.
+        std::vector<uint32> filteredCurves;
 
-        //! Point size of the control coefficients.
-        float32 controlPointSize = 32;
+        size_t nCurvesWhenFiltered = 0;
+
+        bool isCurveFilterDirty = true;
+
+        int32 curvePage = 0;
+
+        //! Number of samples that is used to sample the curve.
+        int32 nSamples = 64;
+
+        //! Colors, line widths and visibility of curve, control polygon and control points.
+        SplineRenderer::Style style;
 
         //! A type for selecting the curve.
         enum CurveType : int32 { Monomial, Lagrange, Bezier};
 
-        bool showControlPolygon = true;
+        int32 renderPath = SplineRenderer::GeometryShader;
 
-        bool showControlPoints = true;
+        bool tieParameters = true;
 
-        bool showCurve = true;
+        //! Parameter interval the selected curve is trimmed to.
+        f32vec2 trimInterval = f32vec2(0.0f, 1.0f);
 
-        f32vec3 curveColor = f32vec3(0.0f, 0.0f, 0.0f);
+        //! Maximal distance between an input point and the fitted spline.
+        float32 fittingTolerance = 0.001f;
 
-        f32vec3 controlPolygonColor = f32vec3(0.5f, 0.5f, 0.5f);
+        //! Number of points of the synthetic pen stroke that is fitted.
+        int32 nFittingPoints = 1000000;
 
-        f32vec3 controlPointColor = f32vec3(0.5f, 0.5f, 0.5f);        
+        //! Statistics of the last fit.
+        size_t fittedInputPoints = 0;
 
-        bool tieParameters = true;
+        size_t fittedSegments = 0;
+
+        float64 fittingSeconds = 0.0;
+
+        //! Statistics of the last simplification.
+        SimplificationResult simplification;
+
+        bool hasSimplified = false;
+
+        //! End condition of the interpolating spline.
+        int32 endCondition = static_cast<int32>(EndCondition::Natural);
+
+        //! Statistics of the last interpolation benchmark.
+        size_t nInterpolatedPoints = 0;
+
+        float64 interpolationSeconds = 0.0;
+
+        //! Peak physical memory of the process after the last interpolation benchmark in megabytes.
+        float64 interpolationPeakMegabytes = 0.0;
+
+        //! Width and height of the image the spline is rasterized into on the CPU.
+        int32 rasterResolution = 2048;
+
+        int32 rasterTileSize = 64;
+
+        //! Throughput of the last rasterization in megapixels per second.
+        float64 referenceMegapixelsPerSecond = 0.0;
+
+        float64 tiledMegapixelsPerSecond = 0.0;
+
+        //! Largest difference in coverage between the tiled and the reference rasterization.
+        int32 rasterDifference = 0;
+
+        //! Number of random cubic curves of the batched evaluation benchmark.
+        int32 nBatchCurves = 100000;
+
+        //! Throughput of the last batched evaluation benchmark in curve evaluations per second.
+        float64 scalarEvaluationsPerSecond = 0.0;
+
+        float64 batchedEvaluationsPerSecond = 0.0;
+
+        //! Degree of the random curves of the frame benchmark.
+        int32 frameDegree = 3;
+
+        //! Throughput of the last frame benchmark in frames per second, from the curve and its hodographs and from a single pass.
+        float64 separateFramesPerSecond = 0.0;
+
+        float64 fusedFramesPerSecond = 0.0;
+
+        //! Number and largest degree of the random curves of the bounding box benchmark.
+        int32 nBoundsCurves = 100000;
+
+        int32 maxBoundsDegree = 3;
+
+        //! Throughput of the last bounding box benchmark in curves per second.
+        float64 exactBoxesPerSecond = 0.0;
+
+        float64 batchedBoxesPerSecond = 0.0;
+
+        float64 sampledBoxesPerSecond = 0.0;
+
+        //! Largest distance by which a sampled box falls short of the exact box.
+        float32 sampledBoxError = 0.0f;
+
+        //! Total area of the boxes of the control points relative to the total area of the exact boxes.
+        float64 controlPointBoxAreaRatio = 0.0;
+
+        //! File the input is recorded to and replayed from.
+        char recordingPath[256] = "recording.txt";
+
+        //! Error of the last attempt to write or read a recording.
+        std::string recordingError;
     };
 
     //! The ui data.
@@ -129,17 +284,26 @@ public:
 
         if(button == GLFW_MOUSE_BUTTON_1)
         {
-            if(action == GLFW_PRESS)
+            if(action == GLFW_PRESS && (mods & GLFW_MOD_CONTROL))
+            {
+                pickCurve(getPointerScenePosition(), getPickRadius());
+            }
+            else if(action == GLFW_PRESS)
             {
-                const auto d = getNormalizedMousePosition();
-                m_pointDragger.onMouseDown(transformPoint(getAspectCorrectionScale() * getCameraTransformation(),
-                    f32vec2(static_cast<float32>(d.x), static_cast<float32>(d.y))),
-                    *m_uiData.controlPoints,
-                    m_uiData.controlPointSize * 2.0f / glm::max(getFramebufferDimensions().x, getFramebufferDimensions().y) / getScaleFactor());
+                const auto& controlPoints = getSelectedCurve().getCoefficients();
+                m_draggedPointIndex = pickControlPoint(getPointerScenePosition(), controlPoints, getPickRadius());
+                if(m_draggedPointIndex >= 0)
+                {
+                    m_dragOffset = controlPoints[m_draggedPointIndex] - getPointerScenePosition();
+                    m_dragStartSpline = m_bezierSpline;
+                }
+                m_hasDragMoved = false;
             }
             else
             {
-                m_pointDragger.onMouseUp();
+                // Release the snapshot, so later edits do not copy the chunks it shares.
+                m_dragStartSpline = BezierSpline();
+                m_draggedPointIndex = -1;
             }
         }
     }
@@ -147,12 +311,43 @@ public:
     void onCursorPosition(float64 xpos, float64 ypos) override
     {
         BaseApp2D::onCursorPosition(xpos, ypos);
-        const auto d = getNormalizedMousePosition();
-        if(m_pointDragger.onMouseMove(transformPoint(getAspectCorrectionScale() * getCameraTransformation(),
-            f32vec2(static_cast<float32>(d.x), static_cast<float32>(d.y))),
-           *m_uiData.controlPoints))
+        // The selection may have changed during the drag, e.g., by an undo.
+        if(m_draggedPointIndex < 0 || static_cast<size_t>(m_draggedPointIndex) >= getSelectedCurve().getOrder())
         {
-            updateCurve();
+            return;
+        }
+        // The chunk is only copied and the curve only recomputed if the point actually moves.
+        const f32vec2 position = getPointerScenePosition() + m_dragOffset;
+        if(position == getSelectedCurve().getCoefficient(m_draggedPointIndex))
+        {
+            return;
+        }
+        if(!m_hasDragMoved)
+        {
+            saveUndoStep(m_dragStartSpline);
+            m_hasDragMoved = true;
+        }
+        m_bezierSpline.editCurve(m_uiData.selectedCurveIndex, [&](BezierCurve<f32vec2>& curve)
+        {
+            curve.getCoefficients()[m_draggedPointIndex] = position;
+        });
+        m_isCurveDirty = true;
+    }
+
+    void onKey(int32_t key, int32_t scancode, int32_t action, int32_t mods) override
+    {
+        BaseApp2D::onKey(key, scancode, action, mods);
+        if(action == GLFW_RELEASE || !(mods & GLFW_MOD_CONTROL) || ImGui::GetIO().WantCaptureKeyboard)
+        {
+            return;
+        }
+        if(key == GLFW_KEY_Z && !(mods & GLFW_MOD_SHIFT))
+        {
+            undo();
+        }
+        else if(key == GLFW_KEY_Y || key == GLFW_KEY_Z)
+        {
+            redo();
         }
     }
 
@@ -161,55 +356,30 @@ public:
     /// </summary>
     void onDraw() override
     {
+        beginFrame();
+        if(m_tessellator.fetchResult(m_sampledCurves))
+        {
+            m_splineRenderer.updateCurves(m_sampledCurves);
+            requestRedraw();
+        }
+
+        if(m_isCurveDirty)
+        {
+            updateCurve();
+            m_isCurveDirty = false;
+        }
+
 		// Clear the window.
 		GL_SAFE_CALL(glClear(GL_COLOR_BUFFER_BIT));
 		const auto pixelScale = (2.0f / std::min(getFramebufferWidth(), getFramebufferHeight()));
 		const auto a = getAspectCorrectionScale();
 		const auto t = getCameraTransformation();
 		const auto m = a * t;
+        const f32vec2 framebufferSize(static_cast<float32>(getFramebufferWidth()), static_cast<float32>(getFramebufferHeight()));
 
-        // Use the draw curve shader to draw the program.
-
-        if(m_uiData.showControlPoints)
-        {
-            m_drawPointsProgram.use();
-            m_drawPointsProgram.setUniform("u_transformationMatrix", m);
-            m_drawPointsProgram.setUniform("u_color", m_uiData.controlPointColor);
-            m_drawPointsProgram.setUniform("u_radius", 0.5f * m_uiData.controlPointSize * f32vec2(2.0f / getFramebufferWidth(), 2.0f / getFramebufferHeight()));
-            for(auto& c : m_controlNetMesh)
-            {
-                c.setPrimitiveType(PolyLineDrawable::Points);
-                c.draw();
-            }
-        }
-
-        if(m_uiData.showControlPolygon)
-        {
-            m_drawCurveProgram.use();
-            m_drawCurveProgram.setUniform("u_color", m_uiData.controlPolygonColor);
-            m_drawCurveProgram.setUniform("u_transformationMatrix", m);
-           // m_drawCurveProgram.setUniform("u_halfLineWidth", 0.5f * m_uiData.curveLineWidth * pixelScale);
-            m_drawCurveProgram.setUniform("u_halfLineWidth", 0.5f * m_uiData.curveLineWidth * pixelScale);
-            for(auto& c : m_controlNetMesh)
-            {
-                c.setPrimitiveType(PolyLineDrawable::LineStripAdjacency);
-                c.draw();
-            }
-        }
-
-        if(m_uiData.showCurve)
-        {
-            m_drawCurveProgram.use();
-            m_drawCurveProgram.setUniform("u_transformationMatrix", m);
-            m_drawCurveProgram.setUniform("u_color", m_uiData.curveColor);
-            m_drawCurveProgram.setUniform("u_halfLineWidth", 0.5f * m_uiData.controlPolygonLineWidth * pixelScale);
-            //m_drawCurveProgram.setUniform("u_halfLineWidth", 1.0f);//
-            for(auto& l : m_lineDrawable)
-            {
-                l.setPrimitiveType(PolyLineDrawable::LineStripAdjacency);
-                l.draw();
-            }
-        }
+        m_renderTimer.begin();
+        m_splineRenderer.draw(m, framebufferSize, m_uiData.style);
+        m_renderTimer.end();
 
         std::vector<f32vec3> colors
             =
@@ -226,36 +396,21 @@ public:
         {
             if(m_uiData.showDecasteljau[i])
             {
-                m_drawCurveProgram.use();
-                m_drawCurveProgram.setUniform("u_color", 0.7f * colors[i%colors.size()]);
-                m_drawCurveProgram.setUniform("u_halfLineWidth", 0.5f * m_uiData.controlPolygonLineWidth * pixelScale);
-                m_drawCurveProgram.setUniform("u_transformationMatrix", getAspectCorrectionScale() * getCameraTransformation());
-
-                m_deCasteljauMeshes[i].setPrimitiveType(PolyLineDrawable::LineStripAdjacency);
-                m_deCasteljauMeshes[i].draw();
-
-                m_drawPointsProgram.use();
-                m_drawPointsProgram.setUniform("u_transformationMatrix", m);
-                m_drawPointsProgram.setUniform("u_color", 0.7f * colors[i % colors.size()]);
-                m_drawPointsProgram.setUniform("u_radius", 0.5f * m_uiData.controlPointSize * f32vec2(2.0f / getFramebufferWidth(), 2.0f / getFramebufferHeight()));
-              
-                m_deCasteljauMeshes[i].setPrimitiveType(PolyLineDrawable::Points);
-                m_deCasteljauMeshes[i].draw();
-                
+                m_splineRenderer.drawLines(m_deCasteljauMeshes[i], m, 0.5f * m_uiData.style.controlPolygonLineWidth * pixelScale, 0.7f * colors[i % colors.size()]);
+                m_splineRenderer.drawPoints(m_deCasteljauMeshes[i], m, 0.5f * m_uiData.style.controlPointSize * f32vec2(2.0f / framebufferSize.x, 2.0f / framebufferSize.y), 0.7f * colors[i % colors.size()]);
             }
         }        
+        endFrame();
     }
 
-    BezierCurve<f32vec2>& getSelectedCurve()
+    const BezierCurve<f32vec2>& getSelectedCurve() const
     {
-        return m_bezierSpline.m_curves[m_uiData.selectedCurveIndex];
+        return m_bezierSpline.getCurve(m_uiData.selectedCurveIndex);
     }
 
     void updateCurveInfoUI()
     {
-        BezierCurve<f32vec2>& curve = getSelectedCurve();
-        const auto nControlPoints = curve.getOrder();
-        m_uiData.controlPoints = &curve.getCoefficients();
+        const auto nControlPoints = getSelectedCurve().getOrder();
         m_uiData.showDecasteljau = std::vector<bool>(nControlPoints);
         m_uiData.sampleValueDeCasteljau = std::vector<float32>(nControlPoints);
     }
@@ -266,7 +421,6 @@ public:
     void onDrawUI() override
     {
         bool curveChanged = false;
-        auto& selectedCurve = m_bezierSpline.m_curves[m_uiData.selectedCurveIndex];
         ImGui::Begin("Options");
         {
             if(ImGui::SliderInt("Curve Idx", &m_uiData.selectedCurveIndex, 0, m_bezierSpline.getNumberOfCurves() - 1))
@@ -274,14 +428,53 @@ public:
                 curveChanged = true;
                 updateCurveInfoUI();
             }
+
+            if(ImGui::Button("Undo"))
+            {
+                undo();
+            }
+            ImGui::SameLine();
+            if(ImGui::Button("Redo"))
+            {
+                redo();
+            }
+            ImGui::SameLine();
+            ImGui::Text("%zu undo, %zu redo steps", m_undoHistory.size(), m_redoHistory.size());
             
+            if(ImGui::CollapsingHeader("Curves"))
+            {
+                curveChanged |= drawCurveList();
+            }
+
             if(ImGui::CollapsingHeader("Control Points"))
             {
-                for(size_t i = 0; i < m_uiData.controlPoints->size(); i++)
+                // Only the visible rows are submitted, so the cost does not depend on the number of control points.
+                const int32 nControlPoints = static_cast<int32>(getSelectedCurve().getCoefficients().size());
+                const float32 rowHeight = ImGui::GetFrameHeightWithSpacing();
+                ImGui::BeginChild("ControlPointTable", ImVec2(0.0f, std::clamp(nControlPoints, 1, MaxVisibleRows) * rowHeight));
+                ImGuiListClipper clipper;
+                clipper.Begin(nControlPoints, rowHeight);
+                while(clipper.Step())
                 {
-                    std::string name = "C" + std::to_string(i);
-                    curveChanged |= ImGui::SliderFloat2(name.c_str(), &(*m_uiData.controlPoints)[i].x, -2.0f, 2.0f);
+                    for(int32 i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+                    {
+                        f32vec2 controlPoint = getSelectedCurve().getCoefficient(i);
+                        const bool hasChanged = ImGui::SliderFloat2(m_uiData.controlPointLabels.get(i), &controlPoint.x, -2.0f, 2.0f);
+                        if(ImGui::IsItemActivated())
+                        {
+                            saveUndoStep(m_bezierSpline);
+                        }
+                        if(hasChanged)
+                        {
+                            m_bezierSpline.editCurve(m_uiData.selectedCurveIndex, [&](BezierCurve<f32vec2>& curve)
+                            {
+                                curve.getCoefficients()[i] = controlPoint;
+                            });
+                            curveChanged = true;
+                        }
+                    }
                 }
+                ImGui::EndChild();
             }
 
             if(ImGui::CollapsingHeader("Evaluation"))
@@ -291,39 +484,246 @@ public:
 
             if(ImGui::Button("Elevate Degree"))
             {               
-                getSelectedCurve().elevateDegree();
+                saveUndoStep(m_bezierSpline);
+                m_bezierSpline.editCurve(m_uiData.selectedCurveIndex, [](BezierCurve<f32vec2>& curve) { curve.elevateDegree(); });
+                // The labels of the curve list contain the degree.
+                m_uiData.isCurveFilterDirty = true;
                 updateCurveInfoUI();
                 curveChanged = true;
             }
 
             if(ImGui::Button("Subdivide"))
             {
+                saveUndoStep(m_bezierSpline);
                 m_bezierSpline.subdivide(m_uiData.selectedCurveIndex);
+                m_uiData.isCurveFilterDirty = true;
                 updateCurveInfoUI();
                 curveChanged = true;
             }
 
+            ImGui::DragFloatRange2("Trim Interval", &m_uiData.trimInterval.x, &m_uiData.trimInterval.y, 0.01f, 0.0f, 1.0f);
+            if(ImGui::Button("Trim"))
+            {
+                saveUndoStep(m_bezierSpline);
+                m_bezierSpline.trim(m_uiData.selectedCurveIndex, m_uiData.trimInterval.x, m_uiData.trimInterval.y);
+                updateCurveInfoUI();
+                curveChanged = true;
+            }
+
+            if(ImGui::CollapsingHeader("Fitting"))
+            {
+                ImGui::SliderFloat("Tolerance", &m_uiData.fittingTolerance, 0.0001f, 0.05f, "%.4f");
+                ImGui::SliderInt("Number of Points", &m_uiData.nFittingPoints, 1000, 10000000);
+                if(ImGui::Button("Fit Noisy Spiral"))
+                {
+                    saveUndoStep(m_bezierSpline);
+                    fitNoisySpiral();
+                    updateCurveInfoUI();
+                    curveChanged = true;
+                }
+                if(m_uiData.fittedSegments > 0)
+                {
+                    ImGui::Text("%zu points -> %zu segments (%.1f : 1)", m_uiData.fittedInputPoints, m_uiData.fittedSegments,
+                        static_cast<float64>(m_uiData.fittedInputPoints) / static_cast<float64>(m_uiData.fittedSegments));
+                    ImGui::Text("%.2f M points/s", static_cast<float64>(m_uiData.fittedInputPoints) / m_uiData.fittingSeconds * 1e-6);
+                }
+
+                if(ImGui::Button("Simplify"))
+                {
+                    saveUndoStep(m_bezierSpline);
+                    m_uiData.simplification = m_bezierSpline.simplify(m_uiData.fittingTolerance);
+                    m_uiData.hasSimplified = true;
+                    m_uiData.isCurveFilterDirty = true;
+                    m_uiData.selectedCurveIndex = std::min<int32>(m_uiData.selectedCurveIndex, m_bezierSpline.getNumberOfCurves() - 1);
+                    updateCurveInfoUI();
+                    curveChanged = true;
+                }
+                if(m_uiData.hasSimplified)
+                {
+                    ImGui::Text("Removed %u curves, max. deviation %.5f", m_uiData.simplification.nRemovedCurves, m_uiData.simplification.maxDeviation);
+                }
+            }
+
+            if(ImGui::CollapsingHeader("Interpolation"))
+            {
+                const char* endConditions[] = { "Natural", "Clamped", "Periodic" };
+                ImGui::Combo("End Condition", &m_uiData.endCondition, endConditions, IM_ARRAYSIZE(endConditions));
+                if(ImGui::Button("Interpolate Control Points"))
+                {
+                    saveUndoStep(m_bezierSpline);
+                    interpolateControlPoints();
+                    updateCurveInfoUI();
+                    curveChanged = true;
+                }
+                if(ImGui::Button("Interpolate Noisy Spiral"))
+                {
+                    interpolateNoisySpiral();
+                }
+                if(m_uiData.nInterpolatedPoints > 0)
+                {
+                    ImGui::Text("%zu points in %.3f s (%.2f M points/s)", m_uiData.nInterpolatedPoints, m_uiData.interpolationSeconds,
+                        static_cast<float64>(m_uiData.nInterpolatedPoints) / m_uiData.interpolationSeconds * 1e-6);
+                    ImGui::Text("Peak memory of the process: %.0f MB", m_uiData.interpolationPeakMegabytes);
+                }
+            }
+
+            if(ImGui::CollapsingHeader("CPU Rasterization"))
+            {
+                ImGui::SliderInt("Resolution", &m_uiData.rasterResolution, 256, 8192);
+                ImGui::SliderInt("Tile Size", &m_uiData.rasterTileSize, 16, 256);
+                if(ImGui::Button("Rasterize to rasterized.png"))
+                {
+                    rasterizeSpline();
+                }
+                if(m_uiData.tiledMegapixelsPerSecond > 0.0)
+                {
+                    ImGui::Text("Reference: %.1f MP/s, tiled: %.1f MP/s (%.2fx)", m_uiData.referenceMegapixelsPerSecond, m_uiData.tiledMegapixelsPerSecond,
+                        m_uiData.tiledMegapixelsPerSecond / m_uiData.referenceMegapixelsPerSecond);
+                    ImGui::Text("Max. coverage difference: %d / 255", m_uiData.rasterDifference);
+                }
+            }
+
+            if(ImGui::CollapsingHeader("Batched Evaluation"))
+            {
+                ImGui::SliderInt("Number of Curves", &m_uiData.nBatchCurves, 1000, 1000000);
+                if(ImGui::Button("Compare Scalar and Batched"))
+                {
+                    benchmarkBatchedEvaluation();
+                }
+                if(m_uiData.batchedEvaluationsPerSecond > 0.0)
+                {
+                    ImGui::Text("Scalar: %.1f M evaluations/s", m_uiData.scalarEvaluationsPerSecond * 1e-6);
+                    ImGui::Text("Batched: %.1f M evaluations/s (%.2fx)", m_uiData.batchedEvaluationsPerSecond * 1e-6,
+                        m_uiData.batchedEvaluationsPerSecond / m_uiData.scalarEvaluationsPerSecond);
+                }
+                ImGui::SliderInt("Degree##Frames", &m_uiData.frameDegree, 1, 6);
+                if(ImGui::Button("Compare Separate and Fused Frames"))
+                {
+                    benchmarkFrameEvaluation();
+                }
+                if(m_uiData.fusedFramesPerSecond > 0.0)
+                {
+                    ImGui::Text("Curve and hodographs: %.1f M frames/s", m_uiData.separateFramesPerSecond * 1e-6);
+                    ImGui::Text("Single pass: %.1f M frames/s (%.2fx)", m_uiData.fusedFramesPerSecond * 1e-6,
+                        m_uiData.fusedFramesPerSecond / m_uiData.separateFramesPerSecond);
+                }
+            }
+
+            if(ImGui::CollapsingHeader("Bounding Boxes"))
+            {
+                ImGui::SliderInt("Number of Curves##Bounds", &m_uiData.nBoundsCurves, 1000, 1000000);
+                ImGui::SliderInt("Max. Degree", &m_uiData.maxBoundsDegree, 1, 6);
+                if(ImGui::Button("Compare Exact and Sampled Bounds"))
+                {
+                    benchmarkBoundingBoxes();
+                }
+                if(m_uiData.exactBoxesPerSecond > 0.0)
+                {
+                    ImGui::Text("Exact: %.1f M curves/s", m_uiData.exactBoxesPerSecond * 1e-6);
+                    ImGui::Text("Batched: %.1f M curves/s", m_uiData.batchedBoxesPerSecond * 1e-6);
+                    ImGui::Text("Sampled: %.1f M curves/s, up to %.5f too small", m_uiData.sampledBoxesPerSecond * 1e-6, m_uiData.sampledBoxError);
+                    ImGui::Text("Control point boxes: %.2fx the exact area", m_uiData.controlPointBoxAreaRatio);
+                }
+            }
+
             if(ImGui::CollapsingHeader("Rendering"))
             {
-                ImGui::Checkbox("Show Curve", &m_uiData.showCurve);
-                if(m_uiData.showCurve)
+                if(ImGui::Button("Fit to View"))
+                {
+                    const auto box = m_bezierSpline.getBoundingBox();
+                    if(!box.isEmpty())
+                    {
+                        fitView(box.min, box.max);
+                    }
+                }
+
+                const char* renderPaths[] = { "Geometry Shader", "Instanced Quads", "Signed Distance" };
+                if(ImGui::Combo("Render Path", &m_uiData.renderPath, renderPaths, IM_ARRAYSIZE(renderPaths)))
+                {
+                    m_renderTimer.reset();
+                    m_splineRenderer.setRenderPath(static_cast<SplineRenderer::RenderPath>(m_uiData.renderPath));
+                    m_splineRenderer.updateCurves(m_sampledCurves);
+                    m_splineRenderer.updateControlNets(m_bezierSpline);
+                    // The signed distance path does not keep the samples up to date.
+                    curveChanged = true;
+                }
+                ImGui::Text("GPU time: %.3f ms", m_renderTimer.getAverageMilliseconds());
+
+                bool isOnDemandRedrawEnabled = this->isOnDemandRedrawEnabled();
+                if(ImGui::Checkbox("On-Demand Redraw", &isOnDemandRedrawEnabled))
+                {
+                    setIsOnDemandRedrawEnabled(isOnDemandRedrawEnabled);
+                }
+                ImGui::Text("Skipped frames: %llu", static_cast<unsigned long long>(getNumberOfSkippedFrames()));
+
+                ImGui::Checkbox("Show Curve", &m_uiData.style.showCurve);
+                if(m_uiData.style.showCurve)
                 {
-                    ImGui::SliderFloat("Curve Width", &m_uiData.curveLineWidth, 1.0f, 32.0f);
-                    ImGui::ColorEdit3("Curve Color", &m_uiData.curveColor.x);
+                    ImGui::SliderFloat("Curve Width", &m_uiData.style.curveLineWidth, 1.0f, 32.0f);
+                    ImGui::ColorEdit3("Curve Color", &m_uiData.style.curveColor.x);
                 }
 
-                ImGui::Checkbox("Show Control Polygon", &m_uiData.showControlPolygon);
-                if(m_uiData.showControlPolygon)
+                ImGui::Checkbox("Show Control Polygon", &m_uiData.style.showControlPolygon);
+                if(m_uiData.style.showControlPolygon)
                 {
-                    ImGui::SliderFloat("Control Polygon Width", &m_uiData.controlPolygonLineWidth, 1.0f, 32.0f);
-                    ImGui::ColorEdit3("Conrol Polygon Color", &m_uiData.controlPolygonColor.x);
+                    ImGui::SliderFloat("Control Polygon Width", &m_uiData.style.controlPolygonLineWidth, 1.0f, 32.0f);
+                    ImGui::ColorEdit3("Conrol Polygon Color", &m_uiData.style.controlPolygonColor.x);
                 }
 
-                ImGui::Checkbox("Show Control Points", &m_uiData.showControlPoints);
-                if(m_uiData.showControlPoints)
+                ImGui::Checkbox("Show Control Points", &m_uiData.style.showControlPoints);
+                if(m_uiData.style.showControlPoints)
                 {
-                    ImGui::SliderFloat("Control Point Size", &m_uiData.controlPointSize, 1.0f, 32.0f);
-                    ImGui::ColorEdit3("Control Point Color", &m_uiData.controlPointColor.x);
+                    ImGui::SliderFloat("Control Point Size", &m_uiData.style.controlPointSize, 1.0f, 32.0f);
+                    ImGui::ColorEdit3("Control Point Color", &m_uiData.style.controlPointColor.x);
+                }
+            }
+
+            if(ImGui::CollapsingHeader("Recording"))
+            {
+                ImGui::InputText("File", m_uiData.recordingPath, sizeof(m_uiData.recordingPath));
+                try
+                {
+                    if(isRecording())
+                    {
+                        if(ImGui::Button("Stop Recording"))
+                        {
+                            stopRecording(m_uiData.recordingPath);
+                        }
+                    }
+                    else if(!isReplaying())
+                    {
+                        if(ImGui::Button("Start Recording"))
+                        {
+                            m_uiData.recordingError.clear();
+                            startRecording();
+                        }
+                        if(ImGui::Button("Replay at Full Speed"))
+                        {
+                            m_uiData.recordingError.clear();
+                            startReplay(m_uiData.recordingPath, false, false);
+                        }
+                        ImGui::SameLine();
+                        if(ImGui::Button("Replay in Real Time"))
+                        {
+                            m_uiData.recordingError.clear();
+                            startReplay(m_uiData.recordingPath, true, false);
+                        }
+                    }
+                }
+                catch(std::exception& exception)
+                {
+                    m_uiData.recordingError = exception.what();
+                }
+                if(!m_uiData.recordingError.empty())
+                {
+                    ImGui::TextUnformatted(m_uiData.recordingError.c_str());
+                }
+
+                const auto& statistics = getReplayStatistics();
+                if(statistics.nEvents > 0)
+                {
+                    ImGui::Text("%zu events, latency p50 %.2f ms, p99 %.2f ms, max %.2f ms", statistics.nEvents,
+                        statistics.p50Milliseconds, statistics.p99Milliseconds, statistics.maxMilliseconds);
                 }
             }
 
@@ -342,16 +742,14 @@ public:
                 {
                     for(size_t i = 0; i < m_uiData.sampleValueDeCasteljau.size()-1; i++)
                     {
-                        std::string name = "t" + std::to_string(i);
-                        curveChanged |= ImGui::SliderFloat(name.c_str(), &m_uiData.sampleValueDeCasteljau[i], 0.0f, 1.0f);
+                        curveChanged |= ImGui::SliderFloat(m_uiData.parameterLabels.get(i), &m_uiData.sampleValueDeCasteljau[i], 0.0f, 1.0f);
                     }
                 }
                 
                 for(size_t i = 0; i < m_deCasteljauMeshes.size(); i++)
                 {
-                    std::string name = "D" + std::to_string(i);
                     bool y = m_uiData.showDecasteljau[i];
-                    curveChanged |= ImGui::Checkbox(name.c_str(), &y);
+                    curveChanged |= ImGui::Checkbox(m_uiData.deCasteljauLabels.get(i), &y);
                     m_uiData.showDecasteljau[i] = y;
                 }
             }
@@ -360,32 +758,235 @@ public:
 
         if(curveChanged)
         {
-            updateCurve();
+            m_isCurveDirty = true;
+            requestRedraw();
         }
     }
 
 private:
+    //! Rows of the scrollable lists. Longer lists scroll. Empty lists keep the height of one row, as ImGui
+    //! stretches a child window of height zero to the whole window.
+    static constexpr int32 MaxVisibleRows = 12;
+
+    //! Number of curves per page of the curve list.
+    static constexpr int32 CurvesPerPage = 1000;
+
+    //! Oldest undo steps are dropped beyond this number.
+    static constexpr size_t MaxUndoSteps = 256;
+
+    //! Samples per curve when picking curves and when bounding them by sampling.
+    static constexpr uint32 PickSamples = 64;
+
+    static constexpr uint32 BoundsSamples = 32;
+
+    /// <summary>
+    /// Pointer position in scene coordinates.
+    /// </summary>
+    f32vec2 getPointerScenePosition() const
+    {
+        const auto d = getPointerPosition();
+        return transformPoint(getAspectCorrectionScale() * getCameraTransformation(), f32vec2(static_cast<float32>(d.x), static_cast<float32>(d.y)));
+    }
+
+    /// <summary>
+    /// Distance in scene coordinates within which control points and curves are hit by the pointer.
+    /// </summary>
+    float32 getPickRadius()
+    {
+        return m_uiData.style.controlPointSize * 2.0f / glm::max(getFramebufferDimensions().x, getFramebufferDimensions().y) / getScaleFactor();
+    }
+
+    /// <summary>
+    /// Index of the control point closest to p within radius, or -1 if there is none.
+    /// </summary>
+    static int32 pickControlPoint(const f32vec2& p, const std::vector<f32vec2>& controlPoints, float32 radius)
+    {
+        float32 closestSquaredDistance = radius * radius;
+        int32 closestPoint = -1;
+        for(size_t i = 0; i < controlPoints.size(); i++)
+        {
+            const f32vec2 d = controlPoints[i] - p;
+            const float32 squaredDistance = d.x * d.x + d.y * d.y;
+            if(squaredDistance <= closestSquaredDistance)
+            {
+                closestSquaredDistance = squaredDistance;
+                closestPoint = static_cast<int32>(i);
+            }
+        }
+        return closestPoint;
+    }
+
+    /// <summary>
+    /// Selects the curve closest to p, if it passes within radius. Only curves whose exact bounding box
+    /// is within radius are sampled.
+    /// </summary>
+    void pickCurve(const f32vec2& p, float32 radius)
+    {
+        BoundingBox<f32vec2> region;
+        region.extend(p - f32vec2(radius, radius));
+        region.extend(p + f32vec2(radius, radius));
+        std::vector<uint32> candidates;
+        m_bezierSpline.findCurves(region, candidates);
+
+        float32 closestSquaredDistance = radius * radius;
+        int32 closestCurve = -1;
+        for(const uint32 i : candidates)
+        {
+            for(const auto& q : m_bezierSpline.getCurve(i).sample(PickSamples))
+            {
+                const f32vec2 d = q - p;
+                const float32 squaredDistance = d.x * d.x + d.y * d.y;
+                if(squaredDistance <= closestSquaredDistance)
+                {
+                    closestSquaredDistance = squaredDistance;
+                    closestCurve = static_cast<int32>(i);
+                }
+            }
+        }
+        if(closestCurve >= 0)
+        {
+            m_uiData.selectedCurveIndex = closestCurve;
+            updateCurveInfoUI();
+            m_isCurveDirty = true;
+        }
+    }
+
+    /// <summary>
+    /// Saves a snapshot of the spline before an edit as undo step and discards the redo steps.
+    /// </summary>
+    void saveUndoStep(const BezierSpline& spline)
+    {
+        m_undoHistory.push_back(spline);
+        if(m_undoHistory.size() > MaxUndoSteps)
+        {
+            m_undoHistory.erase(m_undoHistory.begin());
+        }
+        m_redoHistory.clear();
+    }
+
+    void undo()
+    {
+        if(!m_undoHistory.empty())
+        {
+            m_redoHistory.push_back(m_bezierSpline);
+            restoreSpline(m_undoHistory.back());
+            m_undoHistory.pop_back();
+        }
+    }
+
+    void redo()
+    {
+        if(!m_redoHistory.empty())
+        {
+            m_undoHistory.push_back(m_bezierSpline);
+            restoreSpline(m_redoHistory.back());
+            m_redoHistory.pop_back();
+        }
+    }
+
+    void restoreSpline(const BezierSpline& spline)
+    {
+        m_bezierSpline = spline;
+        m_uiData.selectedCurveIndex = std::min<int32>(m_uiData.selectedCurveIndex, m_bezierSpline.getNumberOfCurves() - 1);
+        m_uiData.isCurveFilterDirty = true;
+        updateCurveInfoUI();
+        m_isCurveDirty = true;
+        requestRedraw();
+    }
+
+    /// <summary>
+    /// Draws a searchable, paged list of the curves. Selecting a curve makes it the edited curve.
+    /// </summary>
+    /// <returns>true, if the selection changed.</returns>
+    bool drawCurveList()
+    {
+        if(m_uiData.curveFilter.Draw("Search"))
+        {
+            m_uiData.isCurveFilterDirty = true;
+        }
+        if(m_uiData.isCurveFilterDirty || m_uiData.nCurvesWhenFiltered != m_bezierSpline.getNumberOfCurves())
+        {
+            updateFilteredCurves();
+        }
+
+        const int32 nFiltered = static_cast<int32>(m_uiData.filteredCurves.size());
+        const int32 nPages = std::max(1, (nFiltered + CurvesPerPage - 1) / CurvesPerPage);
+        m_uiData.curvePage = std::clamp(m_uiData.curvePage, 0, nPages - 1);
+        if(ImGui::ArrowButton("##PreviousPage", ImGuiDir_Left))
+        {
+            m_uiData.curvePage = std::max(0, m_uiData.curvePage - 1);
+        }
+        ImGui::SameLine();
+        if(ImGui::ArrowButton("##NextPage", ImGuiDir_Right))
+        {
+            m_uiData.curvePage = std::min(nPages - 1, m_uiData.curvePage + 1);
+        }
+        ImGui::SameLine();
+        ImGui::Text("Page %d / %d (%d curves)", m_uiData.curvePage + 1, nPages, nFiltered);
+
+        bool selectionChanged = false;
+        const int32 first = m_uiData.curvePage * CurvesPerPage;
+        const int32 nRows = std::min(CurvesPerPage, nFiltered - first);
+        const float32 rowHeight = ImGui::GetTextLineHeightWithSpacing();
+        ImGui::BeginChild("CurveList", ImVec2(0.0f, std::clamp(nRows, 1, MaxVisibleRows) * rowHeight));
+        ImGuiListClipper clipper;
+        clipper.Begin(nRows, rowHeight);
+        while(clipper.Step())
+        {
+            for(int32 row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+            {
+                const uint32 curveIndex = m_uiData.filteredCurves[first + row];
+                char label[64];
+                formatCurveLabel(curveIndex, label, sizeof(label));
+                if(ImGui::Selectable(label, static_cast<int32>(curveIndex) == m_uiData.selectedCurveIndex))
+                {
+                    m_uiData.selectedCurveIndex = static_cast<int32>(curveIndex);
+                    updateCurveInfoUI();
+                    selectionChanged = true;
+                }
+            }
+        }
+        ImGui::EndChild();
+        return selectionChanged;
+    }
+
+    void formatCurveLabel(uint32 curveIndex, char* label, size_t size) const
+    {
+        std::snprintf(label, size, "Curve %u (degree %zu)", curveIndex, m_bezierSpline.getCurve(curveIndex).getDegree());
+    }
+
+    /// <summary>
+    /// Applies the filter to all curves. Only called when the filter or the number of curves changes.
+    /// </summary>
+    void updateFilteredCurves()
+    {
+        m_uiData.filteredCurves.clear();
+        for(uint32 i = 0; i < m_bezierSpline.getNumberOfCurves(); i++)
+        {
+            char label[64];
+            formatCurveLabel(i, label, sizeof(label));
+            if(m_uiData.curveFilter.PassFilter(label))
+            {
+                m_uiData.filteredCurves.push_back(i);
+            }
+        }
+        m_uiData.nCurvesWhenFiltered = m_bezierSpline.getNumberOfCurves();
+        m_uiData.isCurveFilterDirty = false;
+    }
+
     /// /// <summary>
     /// Called every time the user changes parameters of the curve.
+    /// The curve itself is sampled asynchronously by m_tessellator. Only the control net and the
+    /// de Casteljau pyramid, which are cheap to compute, are updated immediately.
     /// </summary>
     void updateCurve()
     {                           
-        m_lineDrawable.clear();
-        for(int32 i = 0; i < m_bezierSpline.m_curves.size(); i++)
+        if(m_uiData.renderPath != SplineRenderer::SignedDistance)
         {
-            const auto& curve = m_bezierSpline.m_curves[i];
-            std::vector<f32vec2> sampledPoints = curve.sample(m_uiData.nSamples);            
-            m_lineDrawable.emplace_back(sampledPoints);
-            m_lineDrawable.back().setPrimitiveType(PolyLineDrawable::LineStrip);
+            m_tessellator.submit(m_bezierSpline, m_uiData.nSamples);
         }
 
-        m_controlNetMesh.clear();
-        for(int32 i = 0; i < m_bezierSpline.m_curves.size(); i++)
-        {
-            const auto& curve = m_bezierSpline.m_curves[i];
-            m_controlNetMesh.emplace_back(curve.getCoefficients());
-            m_controlNetMesh.back().setPrimitiveType(PolyLineDrawable::LineStrip);
-        }
+        m_splineRenderer.updateControlNets(m_bezierSpline);
         const auto& curve = getSelectedCurve();
         
         m_deCasteljauMeshes.clear();
@@ -397,14 +998,382 @@ private:
             m_deCasteljauMeshes.back().setPrimitiveType(PolyLineDrawable::LineStrip);
         }
     }
+
+    /// <summary>
+    /// Writes the number of curves and the selected curve, followed by the control points of all curves, one curve per line.
+    /// </summary>
+    std::string saveScene() const override
+    {
+        std::ostringstream scene;
+        scene.precision(9);
+        scene << m_bezierSpline.getNumberOfCurves() << " " << m_uiData.selectedCurveIndex << "\n";
+        for(const auto& curve : m_bezierSpline)
+        {
+            const auto& controlPoints = curve.getCoefficients();
+            scene << controlPoints.size();
+            for(const auto& p : controlPoints)
+            {
+                scene << " " << p.x << " " << p.y;
+            }
+            scene << "\n";
+        }
+        return scene.str();
+    }
+
+    /// <summary>
+    /// Replaces the spline by a scene written by saveScene.
+    /// </summary>
+    void loadScene(const std::string& sceneDescription) override
+    {
+        std::istringstream scene(sceneDescription);
+        size_t nCurves = 0;
+        int32 selectedCurveIndex = 0;
+        scene >> nCurves >> selectedCurveIndex;
+        std::vector<BezierCurve<f32vec2>> curves;
+        for(size_t i = 0; i < nCurves; i++)
+        {
+            size_t nControlPoints = 0;
+            scene >> nControlPoints;
+            std::vector<f32vec2> controlPoints(nControlPoints);
+            for(auto& p : controlPoints)
+            {
+                scene >> p.x >> p.y;
+            }
+            curves.emplace_back(controlPoints);
+        }
+        if(!scene || curves.empty())
+        {
+            throw cogra::exceptions::RuntimeError("The scene of the recording is corrupt");
+        }
+        m_bezierSpline.setCurves(std::move(curves));
+        m_undoHistory.clear();
+        m_redoHistory.clear();
+        m_uiData.selectedCurveIndex = std::clamp(selectedCurveIndex, 0, static_cast<int32>(m_bezierSpline.getNumberOfCurves()) - 1);
+        m_uiData.isCurveFilterDirty = true;
+        updateCurveInfoUI();
+        m_isCurveDirty = true;
+    }
+
+    /// <summary>
+    /// Replaces the spline by a fit of a densely sampled, noisy spiral that simulates pen input.
+    /// Records compression ratio and throughput of the fitter.
+    /// </summary>
+    void fitNoisySpiral()
+    {
+        const auto points = sampleNoisySpiral(m_uiData.nFittingPoints);
+        m_bezierSpline.clear();
+        SplineFitter fitter(m_bezierSpline, m_uiData.fittingTolerance);
+        const auto start = std::chrono::steady_clock::now();
+        for(const auto& p : points)
+        {
+            fitter.addPoint(p);
+        }
+        fitter.finish();
+        const auto end = std::chrono::steady_clock::now();
+
+        m_uiData.fittedInputPoints = fitter.getNumberOfInputPoints();
+        m_uiData.fittedSegments = fitter.getNumberOfSegments();
+        m_uiData.fittingSeconds = std::chrono::duration<float64>(end - start).count();
+        m_uiData.selectedCurveIndex = 0;
+        m_uiData.isCurveFilterDirty = true;
+    }
+
+    /// <summary>
+    /// Replaces the spline by a C2 cubic spline through the control points of the selected curve.
+    /// </summary>
+    void interpolateControlPoints()
+    {
+        const std::vector<f32vec2> points = getSelectedCurve().getCoefficients();
+        const auto endCondition = static_cast<EndCondition>(m_uiData.endCondition);
+        if(points.size() < (endCondition == EndCondition::Periodic ? 3u : 2u))
+        {
+            return;
+        }
+        m_bezierSpline.interpolate(points, endCondition, points[1] - points[0], points.back() - points[points.size() - 2]);
+        m_uiData.selectedCurveIndex = 0;
+        m_uiData.isCurveFilterDirty = true;
+    }
+
+    /// <summary>
+    /// Measures the throughput and the peak memory of the interpolation on a noisy spiral. The result is not displayed,
+    /// as millions of curves would overwhelm the renderer.
+    /// </summary>
+    void interpolateNoisySpiral()
+    {
+        const auto points = sampleNoisySpiral(m_uiData.nFittingPoints);
+        BezierSpline spline;
+        const auto start = std::chrono::steady_clock::now();
+        spline.interpolate(points, static_cast<EndCondition>(m_uiData.endCondition), f32vec2(1.0f, 0.0f), f32vec2(0.0f, 1.0f));
+        const auto end = std::chrono::steady_clock::now();
+
+        m_uiData.nInterpolatedPoints = points.size();
+        m_uiData.interpolationSeconds = std::chrono::duration<float64>(end - start).count();
+        m_uiData.interpolationPeakMegabytes = static_cast<float64>(getPeakResidentBytes()) / (1024.0 * 1024.0);
+    }
+
+    /// <summary>
+    /// Fills the spline on the CPU, once as a single tile on one thread as reference and once tiled on all threads.
+    /// Records the throughput of both and writes the tiled result.
+    /// </summary>
+    void rasterizeSpline()
+    {
+        const uint32 size = static_cast<uint32>(m_uiData.rasterResolution);
+        const float32 halfSize = 0.5f * static_cast<float32>(size);
+        f32mat3 toPixels(1.0f);
+        toPixels[0] = f32vec3(halfSize, 0.0f, 0.0f);
+        toPixels[1] = f32vec3(0.0f, -halfSize, 0.0f);
+        toPixels[2] = f32vec3(halfSize, halfSize, 1.0f);
+        const auto transformation = toPixels * getCameraTransformation();
+        const float64 megapixels = static_cast<float64>(size) * size * 1e-6;
+
+        RasterizerOptions reference;
+        reference.tileSize = size;
+        reference.nThreads = 1;
+        auto start = std::chrono::steady_clock::now();
+        const Image referenceImage = cogra::gmca::rasterizeSpline(m_bezierSpline, transformation, size, size, reference);
+        auto end = std::chrono::steady_clock::now();
+        m_uiData.referenceMegapixelsPerSecond = megapixels / std::chrono::duration<float64>(end - start).count();
+
+        RasterizerOptions tiled;
+        tiled.tileSize = static_cast<uint32>(m_uiData.rasterTileSize);
+        start = std::chrono::steady_clock::now();
+        const Image tiledImage = cogra::gmca::rasterizeSpline(m_bezierSpline, transformation, size, size, tiled);
+        end = std::chrono::steady_clock::now();
+        m_uiData.tiledMegapixelsPerSecond = megapixels / std::chrono::duration<float64>(end - start).count();
+
+        m_uiData.rasterDifference = 0;
+        for(size_t i = 0; i < tiledImage.pixels.size(); i++)
+        {
+            m_uiData.rasterDifference = std::max(m_uiData.rasterDifference, std::abs(tiledImage.pixels[i] - referenceImage.pixels[i]));
+        }
+        writeImage("rasterized.png", tiledImage);
+    }
+
+    /// <summary>
+    /// Evaluates random cubic curves at a sequence of shared parameters, once curve by curve
+    /// and once with the batched kernel, and records the throughput of both.
+    /// </summary>
+    void benchmarkBatchedEvaluation()
+    {
+        constexpr uint32 nParameters = 16;
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<float32> coordinate(-1.0f, 1.0f);
+        BezierSpline spline;
+        spline.clear();
+        for(int32 i = 0; i < m_uiData.nBatchCurves; i++)
+        {
+            std::vector<f32vec2> controlPoints(4);
+            for(auto& p : controlPoints)
+            {
+                p = f32vec2(coordinate(generator), coordinate(generator));
+            }
+            spline.addCurve(BezierCurve<f32vec2>(controlPoints));
+        }
+        const float64 nEvaluations = static_cast<float64>(nParameters) * spline.getNumberOfCurves();
+
+        std::vector<f32vec2> positions(spline.getNumberOfCurves());
+        auto start = std::chrono::steady_clock::now();
+        for(uint32 j = 0; j < nParameters; j++)
+        {
+            const float32 t = static_cast<float32>(j) / static_cast<float32>(nParameters - 1);
+            size_t i = 0;
+            for(const auto& curve : spline)
+            {
+                positions[i++] = curve.evaluate(t);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        m_uiData.scalarEvaluationsPerSecond = nEvaluations / std::chrono::duration<float64>(end - start).count();
+
+        const BezierCurveBatch batch(spline);
+        start = std::chrono::steady_clock::now();
+        for(uint32 j = 0; j < nParameters; j++)
+        {
+            batch.evaluate(static_cast<float32>(j) / static_cast<float32>(nParameters - 1), positions);
+        }
+        end = std::chrono::steady_clock::now();
+        m_uiData.batchedEvaluationsPerSecond = nEvaluations / std::chrono::duration<float64>(end - start).count();
+    }
+
+    /// <summary>
+    /// Computes position, unit tangent and curvature of random curves at shared parameters, once by evaluating
+    /// the curve and both hodographs and once with the single pass of evaluateFrames, and records the throughput of both.
+    /// The hodographs are computed before the measurement.
+    /// </summary>
+    void benchmarkFrameEvaluation()
+    {
+        constexpr uint32 nParameters = 16;
+        std::mt19937 generator(13);
+        std::uniform_real_distribution<float32> coordinate(-1.0f, 1.0f);
+        std::vector<BezierCurve<f32vec2>> curves;
+        curves.reserve(m_uiData.nBatchCurves);
+        for(int32 i = 0; i < m_uiData.nBatchCurves; i++)
+        {
+            std::vector<f32vec2> controlPoints(m_uiData.frameDegree + 1);
+            for(auto& p : controlPoints)
+            {
+                p = f32vec2(coordinate(generator), coordinate(generator));
+            }
+            curves.emplace_back(controlPoints);
+            curves.back().updateCache();
+        }
+        std::vector<float32> parameters(nParameters);
+        for(uint32 j = 0; j < nParameters; j++)
+        {
+            parameters[j] = static_cast<float32>(j) / static_cast<float32>(nParameters - 1);
+        }
+        const float64 nFrames = static_cast<float64>(nParameters) * curves.size();
+
+        std::vector<BezierCurve<f32vec2>::Frame> frames(curves.size() * nParameters);
+        auto start = std::chrono::steady_clock::now();
+        size_t k = 0;
+        for(const auto& curve : curves)
+        {
+            const auto& firstHodograph = curve.getFirstHodograph();
+            const auto& secondHodograph = curve.getSecondHodograph();
+            for(const float32 t : parameters)
+            {
+                frames[k++] = BezierCurve<f32vec2>::computeFrame(curve.evaluate(t),
+                    BezierCurve<f32vec2>::evaluate(firstHodograph, t), BezierCurve<f32vec2>::evaluate(secondHodograph, t));
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        m_uiData.separateFramesPerSecond = nFrames / std::chrono::duration<float64>(end - start).count();
+
+        std::vector<BezierCurve<f32vec2>::Frame> curveFrames;
+        start = std::chrono::steady_clock::now();
+        k = 0;
+        for(const auto& curve : curves)
+        {
+            curve.evaluateFrames(parameters, curveFrames);
+            std::copy(curveFrames.begin(), curveFrames.end(), frames.begin() + k);
+            k += curveFrames.size();
+        }
+        end = std::chrono::steady_clock::now();
+        m_uiData.fusedFramesPerSecond = nFrames / std::chrono::duration<float64>(end - start).count();
+    }
+
+    /// <summary>
+    /// Bounds random curves exactly, exactly in batches and by sampling, and records the throughput of all three.
+    /// Also records how far the sampled boxes fall short of the exact ones and how loose the boxes of the control points are.
+    /// </summary>
+    void benchmarkBoundingBoxes()
+    {
+        std::mt19937 generator(11);
+        std::uniform_real_distribution<float32> coordinate(-1.0f, 1.0f);
+        std::uniform_int_distribution<int32> degree(1, m_uiData.maxBoundsDegree);
+        const size_t nCurves = static_cast<size_t>(m_uiData.nBoundsCurves);
+        std::vector<BezierCurve<f32vec2>> curves;
+        curves.reserve(nCurves);
+        for(size_t i = 0; i < nCurves; i++)
+        {
+            std::vector<f32vec2> controlPoints(degree(generator) + 1);
+            for(auto& p : controlPoints)
+            {
+                p = f32vec2(coordinate(generator), coordinate(generator));
+            }
+            curves.emplace_back(controlPoints);
+        }
+
+        std::vector<BoundingBox<f32vec2>> exactBoxes(nCurves);
+        auto start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < nCurves; i++)
+        {
+            exactBoxes[i] = BezierCurve<f32vec2>::computeBoundingBox(curves[i].getCoefficients());
+        }
+        auto end = std::chrono::steady_clock::now();
+        m_uiData.exactBoxesPerSecond = nCurves / std::chrono::duration<float64>(end - start).count();
+
+        BezierSpline spline;
+        spline.setCurves(curves);
+        const BezierCurveBatch batch(spline);
+        std::vector<BoundingBox<f32vec2>> batchedBoxes;
+        start = std::chrono::steady_clock::now();
+        batch.computeBoundingBoxes(batchedBoxes);
+        end = std::chrono::steady_clock::now();
+        m_uiData.batchedBoxesPerSecond = nCurves / std::chrono::duration<float64>(end - start).count();
+
+        std::vector<BoundingBox<f32vec2>> sampledBoxes(nCurves);
+        start = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < nCurves; i++)
+        {
+            const auto& controlPoints = curves[i].getCoefficients();
+            for(uint32 j = 0; j < BoundsSamples; j++)
+            {
+                sampledBoxes[i].extend(BezierCurve<f32vec2>::evaluate(controlPoints, static_cast<float32>(j) / static_cast<float32>(BoundsSamples - 1)));
+            }
+        }
+        end = std::chrono::steady_clock::now();
+        m_uiData.sampledBoxesPerSecond = nCurves / std::chrono::duration<float64>(end - start).count();
+
+        m_uiData.sampledBoxError = 0.0f;
+        float64 controlPointArea = 0.0;
+        float64 exactArea = 0.0;
+        for(size_t i = 0; i < nCurves; i++)
+        {
+            const auto& exact = exactBoxes[i];
+            const auto& sampled = sampledBoxes[i];
+            m_uiData.sampledBoxError = std::max({ m_uiData.sampledBoxError, sampled.min.x - exact.min.x, sampled.min.y - exact.min.y,
+                exact.max.x - sampled.max.x, exact.max.y - sampled.max.y });
+
+            BoundingBox<f32vec2> controlPointBox;
+            for(const auto& p : curves[i].getCoefficients())
+            {
+                controlPointBox.extend(p);
+            }
+            controlPointArea += controlPointBox.getArea();
+            exactArea += exact.getArea();
+        }
+        m_uiData.controlPointBoxAreaRatio = controlPointArea / exactArea;
+    }
+
+    /// <summary>
+    /// Densely samples a spiral with noise that simulates pen input.
+    /// </summary>
+    std::vector<f32vec2> sampleNoisySpiral(int32 n) const
+    {
+        constexpr float32 pi = 3.14159265f;
+        std::vector<f32vec2> points;
+        points.reserve(n);
+        std::mt19937 generator(42);
+        // Within two standard deviations, the noise spans the whole tolerance, so the fitter has to absorb it rather than trace it.
+        std::normal_distribution<float32> noise(0.0f, 0.25f * m_uiData.fittingTolerance);
+        for(int32 i = 0; i < n; i++)
+        {
+            const float32 t = 6.0f * pi * static_cast<float32>(i) / static_cast<float32>(n);
+            const float32 r = 0.1f + 0.1f * t / pi;
+            points.emplace_back(r * std::cos(t) + noise(generator), r * std::sin(t) + noise(generator));
+        }
+        return points;
+    }
 };
 }
 
 
-int main()
+int main(int argc, char** argv)
 {
     try
     {
+        cogra::gmca::HeadlessExportConfig exportConfig;
+        if(cogra::gmca::parseHeadlessExportArguments(argc, argv, exportConfig))
+        {
+            cogra::gmca::runHeadlessExport(exportConfig);
+            return 0;
+        }
+
+        for(int i = 1; i < argc; i++)
+        {
+            const std::string argument = argv[i];
+            if(argument == "--replay" && i + 1 < argc)
+            {
+                g_replayOptions.path = argv[++i];
+            }
+            else if(argument == "--realtime")
+            {
+                g_replayOptions.useRecordedTiming = true;
+            }
+        }
+
         GLFWWindowConfig c;
         c.width = 768;
         c.height = 768;
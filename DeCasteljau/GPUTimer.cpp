@@ -0,0 +1,50 @@
+#include "GPUTimer.h"
+#include <cogra/gl/OpenGLRuntimeError.h>
+namespace cogra::gmca
+{
+GPUTimer::GPUTimer()
+    : m_queries{ 0, 0 }
+    , m_isPending{ false, false }
+    , m_current(0)
+    , m_averageMilliseconds(0.0)
+{
+    GL_SAFE_CALL(glGenQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data()));
+}
+
+GPUTimer::~GPUTimer()
+{
+    glDeleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+}
+
+void GPUTimer::begin()
+{
+    if(m_isPending[m_current])
+    {
+        GLuint64 nanoseconds = 0;
+        GL_SAFE_CALL(glGetQueryObjectui64v(m_queries[m_current], GL_QUERY_RESULT, &nanoseconds));
+        const float64 milliseconds = static_cast<float64>(nanoseconds) * 1e-6;
+        m_averageMilliseconds = (m_averageMilliseconds == 0.0) ? milliseconds : 0.95 * m_averageMilliseconds + 0.05 * milliseconds;
+        m_isPending[m_current] = false;
+    }
+    GL_SAFE_CALL(glBeginQuery(GL_TIME_ELAPSED, m_queries[m_current]));
+}
+
+void GPUTimer::end()
+{
+    GL_SAFE_CALL(glEndQuery(GL_TIME_ELAPSED));
+    m_isPending[m_current] = true;
+    m_current = (m_current + 1) % m_queries.size();
+}
+
+float64 GPUTimer::getAverageMilliseconds() const
+{
+    return m_averageMilliseconds;
+}
+
+void GPUTimer::reset()
+{
+    // Results of queries that are still in flight belong to the old measurement and are dropped.
+    m_isPending = { false, false };
+    m_averageMilliseconds = 0.0;
+}
+}
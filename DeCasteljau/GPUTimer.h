@@ -0,0 +1,47 @@
+#pragma once
+#include <glad/glad.h>
+#include <cogra/types.h>
+#include <array>
+namespace cogra::gmca
+{
+/// <summary>
+/// Measures the GPU time of a sequence of draw calls with GL_TIME_ELAPSED queries.
+///
+/// Two queries are used alternately, so the result of the previous frame is read back while the
+/// current frame is recorded and the pipeline is not stalled.
+/// </summary>
+class GPUTimer
+{
+public:
+    GPUTimer();
+
+    ~GPUTimer();
+
+    GPUTimer(const GPUTimer&) = delete;
+
+    GPUTimer& operator=(const GPUTimer&) = delete;
+
+    void begin();
+
+    void end();
+
+    /// <summary>
+    /// Returns an exponential moving average of the measured times in milliseconds.
+    /// </summary>
+    float64 getAverageMilliseconds() const;
+
+    /// <summary>
+    /// Forgets the previous measurements, e.g., after switching between code paths.
+    /// </summary>
+    void reset();
+
+private:
+    std::array<GLuint, 2>   m_queries;
+
+    std::array<bool, 2>     m_isPending;
+
+    uint32                  m_current;
+
+    float64                 m_averageMilliseconds;
+};
+}
@@ -0,0 +1,93 @@
+#include "HeadlessContext.h"
+#include <glad/glad.h>
+#include <cogra/exceptions/RuntimeError.h>
+#ifdef COGRA_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+namespace cogra::ui
+{
+#ifdef COGRA_HAS_EGL
+HeadlessContext::HeadlessContext(int32 glMajorVersion, int32 glMinorVersion)
+    : m_display(nullptr)
+    , m_context(nullptr)
+{
+    EGLDisplay display = EGL_NO_DISPLAY;
+    const auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if(getPlatformDisplay != nullptr)
+    {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if(display == EGL_NO_DISPLAY)
+    {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    if(display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+    {
+        throw cogra::exceptions::RuntimeError("Cannot initialize an EGL display");
+    }
+    m_display = display;
+
+    if(!eglBindAPI(EGL_OPENGL_API))
+    {
+        eglTerminate(display);
+        throw cogra::exceptions::RuntimeError("EGL does not support OpenGL");
+    }
+
+    const EGLint configAttributes[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig config = nullptr;
+    EGLint nConfigs = 0;
+    if(!eglChooseConfig(display, configAttributes, &config, 1, &nConfigs) || nConfigs == 0)
+    {
+        // Surfaceless rendering needs no config if EGL_KHR_no_config_context is supported.
+        config = nullptr;
+    }
+
+    const EGLint contextAttributes[] =
+    {
+        EGL_CONTEXT_MAJOR_VERSION, glMajorVersion,
+        EGL_CONTEXT_MINOR_VERSION, glMinorVersion,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if(context == EGL_NO_CONTEXT)
+    {
+        eglTerminate(display);
+        throw cogra::exceptions::RuntimeError("Cannot create an OpenGL context with EGL");
+    }
+    m_context = context;
+
+    if(!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        eglDestroyContext(display, context);
+        eglTerminate(display);
+        throw cogra::exceptions::RuntimeError("Cannot make the EGL context current without a surface");
+    }
+
+    if(!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress)))
+    {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+        eglTerminate(display);
+        throw cogra::exceptions::RuntimeError("Cannot load the OpenGL functions");
+    }
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(m_display, m_context);
+    eglTerminate(m_display);
+}
+#else
+HeadlessContext::HeadlessContext(int32, int32)
+    : m_display(nullptr)
+    , m_context(nullptr)
+{
+    throw cogra::exceptions::RuntimeError("Headless rendering requires EGL, which is not available on this platform");
+}
+
+HeadlessContext::~HeadlessContext() = default;
+#endif
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cogra/types.h>
+namespace cogra::ui
+{
+/// <summary>
+/// An OpenGL context without a window.
+///
+/// The context is created with EGL on Mesa's surfaceless platform, which works with the llvmpipe
+/// software rasterizer and needs neither a display server nor a GPU. Render into a framebuffer object,
+/// e.g. an OffscreenFramebuffer. The context is current after construction and the OpenGL functions
+/// are loaded.
+/// </summary>
+class HeadlessContext
+{
+public:
+    HeadlessContext(int32 glMajorVersion = 3, int32 glMinorVersion = 3);
+
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+private:
+    //! EGLDisplay and EGLContext. Kept opaque to keep the EGL headers out of this header.
+    void*   m_display;
+
+    void*   m_context;
+};
+}
@@ -0,0 +1,225 @@
+#include "HeadlessExporter.h"
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <cogra/gl/OpenGLRuntimeError.h>
+#include <cogra/exceptions/RuntimeError.h>
+#include "BezierSpline.h"
+#include "HeadlessContext.h"
+#include "ImageIO.h"
+#include "OffscreenFramebuffer.h"
+namespace cogra::gmca
+{
+namespace
+{
+/// <summary>
+/// Creates a spline of up to four connected cubic curves. The same index always yields the same spline.
+/// </summary>
+BezierSpline createRandomSpline(uint32 index)
+{
+    std::mt19937 generator(index);
+    std::uniform_real_distribution<float32> coordinate(-0.8f, 0.8f);
+    std::uniform_int_distribution<int32> nCurves(1, 4);
+
+    BezierSpline spline;
+    spline.clear();
+    f32vec2 start(coordinate(generator), coordinate(generator));
+    for(int32 i = nCurves(generator); i > 0; i--)
+    {
+        std::vector<f32vec2> controlPoints = { start };
+        for(int32 j = 0; j < 3; j++)
+        {
+            controlPoints.emplace_back(coordinate(generator), coordinate(generator));
+        }
+        start = controlPoints.back();
+        spline.addCurve(BezierCurve<f32vec2>(controlPoints));
+    }
+    return spline;
+}
+
+/// <summary>
+/// Camera pose with the same layout as TransformationController2D::transformation. Pose 0 is the identity.
+/// </summary>
+f32mat3 createCameraPose(uint32 splineIndex, uint32 poseIndex)
+{
+    if(poseIndex == 0)
+    {
+        return f32mat3(1.0f);
+    }
+    std::mt19937 generator(splineIndex * 7919u + poseIndex);
+    std::uniform_real_distribution<float32> scale(0.6f, 1.4f);
+    std::uniform_real_distribution<float32> translation(-0.3f, 0.3f);
+    const float32 s = scale(generator);
+    return f32mat3(s, 0, 0,
+                   0, s, 0,
+                   translation(generator), translation(generator), 1);
+}
+
+/// <summary>
+/// Parses a count or size that must be at least one. Unlike std::stoul, rejects signs, whitespace and trailing characters.
+/// </summary>
+uint32 parsePositive(const std::string& value, const std::string& option)
+{
+    unsigned long result = 0;
+    size_t end = 0;
+    if(!value.empty() && std::isdigit(static_cast<unsigned char>(value[0])))
+    {
+        try
+        {
+            result = std::stoul(value, &end);
+        }
+        catch(const std::exception&)
+        {
+            end = 0;
+        }
+    }
+    if(end == 0 || end != value.size() || result == 0 || result > std::numeric_limits<uint32>::max())
+    {
+        throw cogra::exceptions::RuntimeError("Invalid value for " + option + ": " + value);
+    }
+    return static_cast<uint32>(result);
+}
+}
+
+bool parseHeadlessExportArguments(int argc, char** argv, HeadlessExportConfig& config)
+{
+    bool isHeadless = false;
+    for(int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        const bool needsValue = argument == "--splines" || argument == "--poses" || argument == "--samples"
+            || argument == "--size" || argument == "--format" || argument == "--render-path";
+        if(needsValue && !hasValue)
+        {
+            throw cogra::exceptions::RuntimeError("Missing value for " + argument);
+        }
+
+        if(argument == "--headless")
+        {
+            isHeadless = true;
+            if(hasValue && argv[i + 1][0] != '-')
+            {
+                config.outputDirectory = argv[++i];
+            }
+        }
+        else if(argument == "--splines")
+        {
+            config.nSplines = parsePositive(argv[++i], argument);
+        }
+        else if(argument == "--poses")
+        {
+            config.nPosesPerSpline = parsePositive(argv[++i], argument);
+        }
+        else if(argument == "--samples")
+        {
+            config.nMultisamples = parsePositive(argv[++i], argument);
+        }
+        else if(argument == "--size")
+        {
+            const std::string value = argv[++i];
+            const auto x = value.find('x');
+            try
+            {
+                config.width = parsePositive(value.substr(0, x), argument);
+                config.height = (x == std::string::npos) ? config.width : parsePositive(value.substr(x + 1), argument);
+            }
+            catch(const std::exception&)
+            {
+                // Report the whole value, e.g., "0x64" rather than "0".
+                throw cogra::exceptions::RuntimeError("Invalid value for " + argument + ": " + value);
+            }
+        }
+        else if(argument == "--format")
+        {
+            const std::string value = argv[++i];
+            if(value != "png" && value != "ppm")
+            {
+                throw cogra::exceptions::RuntimeError("Invalid value for " + argument + ": " + value);
+            }
+            config.format = value;
+        }
+        else if(argument == "--render-path")
+        {
+            const std::string value = argv[++i];
+            if(value == "gs")
+            {
+                config.renderPath = SplineRenderer::GeometryShader;
+            }
+            else if(value == "instanced")
+            {
+                config.renderPath = SplineRenderer::Instanced;
+            }
+            else if(value == "sdf")
+            {
+                config.renderPath = SplineRenderer::SignedDistance;
+            }
+            else
+            {
+                throw cogra::exceptions::RuntimeError("Invalid value for " + argument + ": " + value);
+            }
+        }
+    }
+    return isHeadless;
+}
+
+void runHeadlessExport(const HeadlessExportConfig& config)
+{
+    cogra::ui::HeadlessContext context;
+    SplineRenderer renderer(config.shaderDirectory);
+    renderer.setRenderPath(config.renderPath);
+    OffscreenFramebuffer framebuffer(config.width, config.height, config.nMultisamples);
+    std::filesystem::create_directories(config.outputDirectory);
+
+    // Thumbnails are small, so the line widths are smaller than in the interactive app.
+    SplineRenderer::Style style;
+    style.curveLineWidth = 3.0f;
+    style.controlPolygonLineWidth = 1.5f;
+    style.controlPointSize = 6.0f;
+
+    // Same aspect correction as BaseApp2D::onFramebufferSize.
+    const float32 w = static_cast<float32>(config.width);
+    const float32 h = static_cast<float32>(config.height);
+    const f32vec2 aspectCorrection = (w < h) ? f32vec2(1.0f, w / h) : f32vec2(h / w, 1.0f);
+    const f32mat3 aspectCorrectionScale(aspectCorrection.x, 0, 0, 0, aspectCorrection.y, 0, 0, 0, 1);
+
+    GL_SAFE_CALL(glClearColor(1.0f, 1.0f, 1.0f, 1.0f));
+    const auto start = std::chrono::steady_clock::now();
+    for(uint32 i = 0; i < config.nSplines; i++)
+    {
+        const BezierSpline spline = createRandomSpline(i);
+        if(config.renderPath != SplineRenderer::SignedDistance)
+        {
+            std::vector<std::vector<f32vec2>> sampledCurves;
+            sampledCurves.reserve(spline.getNumberOfCurves());
+            for(const auto& curve : spline)
+            {
+                sampledCurves.push_back(curve.sample(config.nCurveSamples));
+            }
+            renderer.updateCurves(sampledCurves);
+        }
+        renderer.updateControlNets(spline);
+
+        for(uint32 j = 0; j < config.nPosesPerSpline; j++)
+        {
+            framebuffer.bind();
+            GL_SAFE_CALL(glClear(GL_COLOR_BUFFER_BIT));
+            renderer.draw(aspectCorrectionScale * createCameraPose(i, j), f32vec2(w, h), style);
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "spline_%06u_pose_%03u.", i, j);
+            writeImage((std::filesystem::path(config.outputDirectory) / (name + config.format)).string(), framebuffer.read());
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const float64 seconds = std::chrono::duration<float64>(end - start).count();
+    const uint64 nImages = static_cast<uint64>(config.nSplines) * config.nPosesPerSpline;
+    std::cout << "Wrote " << nImages << " images to " << config.outputDirectory << " in " << seconds << " s ("
+        << static_cast<float64>(nImages) / seconds * 60.0 << " images per minute)\n";
+}
+}
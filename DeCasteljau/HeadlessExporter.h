@@ -0,0 +1,53 @@
+#pragma once
+#include <cogra/types.h>
+#include <string>
+#include "SplineRenderer.h"
+namespace cogra::gmca
+{
+/// <summary>
+/// Settings of a batch export of spline thumbnails without a window.
+/// </summary>
+struct HeadlessExportConfig
+{
+    std::string                 outputDirectory = "thumbnails";
+
+    //! Number of random splines.
+    uint32                      nSplines = 100;
+
+    //! Number of camera poses per spline. Every pose is written to its own image.
+    uint32                      nPosesPerSpline = 1;
+
+    uint32                      width = 256;
+
+    uint32                      height = 256;
+
+    //! Number of samples per pixel for antialiasing.
+    uint32                      nMultisamples = 4;
+
+    //! Number of samples that is used to sample each curve.
+    uint32                      nCurveSamples = 64;
+
+    //! "png" or "ppm".
+    std::string                 format = "png";
+
+    //! Instanced quads avoid geometry shaders, which are slow on software rasterizers. The signed
+    //! distance path skips sampling the curves altogether.
+    SplineRenderer::RenderPath  renderPath = SplineRenderer::Instanced;
+
+    std::string                 shaderDirectory = "../shaders/";
+};
+
+/// <summary>
+/// Parses the command line. Recognizes --headless [outputDirectory] followed by the options
+/// --splines n, --poses n, --size widthxheight, --samples n, --format png|ppm, --render-path gs|instanced|sdf.
+/// Throws if an option lacks its value or a count or size is not a positive number.
+/// </summary>
+/// <returns>true, if --headless was given.</returns>
+bool parseHeadlessExportArguments(int argc, char** argv, HeadlessExportConfig& config);
+
+/// <summary>
+/// Renders random splines from several camera poses into an offscreen framebuffer and writes one image per pose.
+/// Creates its own headless OpenGL context, so no window is opened.
+/// </summary>
+void runHeadlessExport(const HeadlessExportConfig& config);
+}
@@ -0,0 +1,159 @@
+#include "ImageIO.h"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <cogra/exceptions/RuntimeError.h>
+namespace cogra::gmca
+{
+namespace
+{
+std::ofstream openForWriting(const std::string& path)
+{
+    std::ofstream file(path, std::ios::binary);
+    if(!file)
+    {
+        throw cogra::exceptions::RuntimeError("Cannot open " + path + " for writing");
+    }
+    return file;
+}
+
+uint32 crc32(const uint8* data, size_t size, uint32 crc = 0)
+{
+    static const std::array<uint32, 256> table = []
+    {
+        std::array<uint32, 256> result;
+        for(uint32 n = 0; n < 256; n++)
+        {
+            uint32 c = n;
+            for(int32 k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            result[n] = c;
+        }
+        return result;
+    }();
+
+    crc = ~crc;
+    for(size_t i = 0; i < size; i++)
+    {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void appendBigEndian(std::vector<uint8>& buffer, uint32 value)
+{
+    buffer.push_back(static_cast<uint8>(value >> 24));
+    buffer.push_back(static_cast<uint8>(value >> 16));
+    buffer.push_back(static_cast<uint8>(value >> 8));
+    buffer.push_back(static_cast<uint8>(value));
+}
+
+void writeChunk(std::ofstream& file, const char* type, const std::vector<uint8>& data)
+{
+    std::vector<uint8> chunk;
+    chunk.reserve(data.size() + 12);
+    appendBigEndian(chunk, static_cast<uint32>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    appendBigEndian(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+    file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+}
+}
+
+void writePPM(const std::string& path, const Image& image)
+{
+    if(image.nChannels != 1 && image.nChannels != 3)
+    {
+        throw cogra::exceptions::RuntimeError("PPM supports one or three channels only");
+    }
+    auto file = openForWriting(path);
+    file << (image.nChannels == 1 ? "P5" : "P6") << "\n" << image.width << " " << image.height << "\n255\n";
+    file.write(reinterpret_cast<const char*>(image.pixels.data()), image.pixels.size());
+}
+
+void writePNG(const std::string& path, const Image& image)
+{
+    uint8 colorType = 0;
+    switch(image.nChannels)
+    {
+    case 1: colorType = 0; break;
+    case 3: colorType = 2; break;
+    case 4: colorType = 6; break;
+    default: throw cogra::exceptions::RuntimeError("PNG supports one, three or four channels only");
+    }
+
+    // Every row is prefixed with filter type 0 (none).
+    const size_t rowSize = static_cast<size_t>(image.width) * image.nChannels;
+    std::vector<uint8> raw;
+    raw.reserve((rowSize + 1) * image.height);
+    for(uint32 y = 0; y < image.height; y++)
+    {
+        raw.push_back(0);
+        const auto row = image.pixels.begin() + y * rowSize;
+        raw.insert(raw.end(), row, row + rowSize);
+    }
+
+    // zlib stream of stored deflate blocks with at most 65535 bytes each.
+    std::vector<uint8> compressed;
+    compressed.reserve(raw.size() + raw.size() / 65535 * 5 + 11);
+    compressed.push_back(0x78);
+    compressed.push_back(0x01);
+    size_t offset = 0;
+    do
+    {
+        const size_t blockSize = std::min<size_t>(raw.size() - offset, 65535);
+        const bool isLast = offset + blockSize == raw.size();
+        compressed.push_back(isLast ? 1 : 0);
+        compressed.push_back(static_cast<uint8>(blockSize));
+        compressed.push_back(static_cast<uint8>(blockSize >> 8));
+        compressed.push_back(static_cast<uint8>(~blockSize));
+        compressed.push_back(static_cast<uint8>(~blockSize >> 8));
+        compressed.insert(compressed.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+        offset += blockSize;
+    } while(offset < raw.size());
+
+    uint32 a = 1;
+    uint32 b = 0;
+    for(const auto byte : raw)
+    {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(compressed, (b << 16) | a);
+
+    std::vector<uint8> header;
+    appendBigEndian(header, image.width);
+    appendBigEndian(header, image.height);
+    header.push_back(8);
+    header.push_back(colorType);
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+
+    auto file = openForWriting(path);
+    const uint8 signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+    writeChunk(file, "IHDR", header);
+    writeChunk(file, "IDAT", compressed);
+    writeChunk(file, "IEND", {});
+}
+
+void writeImage(const std::string& path, const Image& image)
+{
+    const auto extension = path.substr(path.find_last_of('.') + 1);
+    if(extension == "png")
+    {
+        writePNG(path, image);
+    }
+    else if(extension == "ppm" || extension == "pgm")
+    {
+        writePPM(path, image);
+    }
+    else
+    {
+        throw cogra::exceptions::RuntimeError("Unsupported image format: " + path);
+    }
+}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cogra/types.h>
+#include <string>
+#include <vector>
+namespace cogra::gmca
+{
+/// <summary>
+/// An 8 bit image in memory. Rows are stored top to bottom, channels are interleaved.
+/// </summary>
+struct Image
+{
+    Image() = default;
+
+    Image(uint32 width, uint32 height, uint32 nChannels)
+        : width(width)
+        , height(height)
+        , nChannels(nChannels)
+        , pixels(static_cast<size_t>(width) * height * nChannels, 0)
+    {
+    }
+
+    uint32              width = 0;
+
+    uint32              height = 0;
+
+    //! 1 for gray scale, 3 for RGB, 4 for RGBA.
+    uint32              nChannels = 0;
+
+    std::vector<uint8>  pixels;
+};
+
+/// <summary>
+/// Writes a binary PGM (one channel) or PPM (three channels) file. Throws on failure.
+/// </summary>
+void writePPM(const std::string& path, const Image& image);
+
+/// <summary>
+/// Writes an uncompressed PNG file. Throws on failure.
+///
+/// The image data is stored in deflate blocks without compression. This avoids a dependency on zlib
+/// and keeps writing cheap, which matters more for batch exports than the file size.
+/// </summary>
+void writePNG(const std::string& path, const Image& image);
+
+/// <summary>
+/// Writes a PNG or PPM file depending on the extension of path.
+/// </summary>
+void writeImage(const std::string& path, const Image& image);
+}
@@ -0,0 +1,92 @@
+#include "InputRecording.h"
+#include <algorithm>
+#include <fstream>
+#include <cogra/exceptions/RuntimeError.h>
+namespace cogra::ui
+{
+namespace
+{
+const std::string FileHeader = "DeCasteljauInputRecording 1";
+
+float64 percentile(std::vector<float64>& values, float64 p)
+{
+    const size_t k = std::min(values.size() - 1, static_cast<size_t>(p * static_cast<float64>(values.size())));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+}
+
+void writeInputRecording(const std::string& path, const InputRecording& recording)
+{
+    std::ofstream file(path);
+    if(!file)
+    {
+        throw cogra::exceptions::RuntimeError("Cannot open " + path + " for writing");
+    }
+    file.precision(17);
+    file << FileHeader << "\n";
+    file << "framebuffer " << recording.framebufferWidth << " " << recording.framebufferHeight << "\n";
+    file << "scene " << recording.scene.size() << "\n" << recording.scene << "\n";
+    file << "events " << recording.events.size() << "\n";
+    for(const auto& e : recording.events)
+    {
+        file << e.type << " " << e.time << " " << e.frame << " " << e.button << " " << e.action << " " << e.mods << " "
+            << e.pointerPosition.x << " " << e.pointerPosition.y << "\n";
+    }
+    if(!file)
+    {
+        throw cogra::exceptions::RuntimeError("Cannot write " + path);
+    }
+}
+
+InputRecording readInputRecording(const std::string& path)
+{
+    std::ifstream file(path);
+    if(!file)
+    {
+        throw cogra::exceptions::RuntimeError("Cannot open " + path);
+    }
+
+    InputRecording recording;
+    std::string line;
+    std::string keyword;
+    size_t size = 0;
+    std::getline(file, line);
+    if(line != FileHeader)
+    {
+        throw cogra::exceptions::RuntimeError(path + " is not an input recording");
+    }
+    file >> keyword >> recording.framebufferWidth >> recording.framebufferHeight;
+    file >> keyword >> size;
+    file.ignore(1);
+    recording.scene.resize(size);
+    file.read(&recording.scene[0], static_cast<std::streamsize>(size));
+    file >> keyword >> size;
+    recording.events.resize(size);
+    for(auto& e : recording.events)
+    {
+        int32 type = 0;
+        file >> type >> e.time >> e.frame >> e.button >> e.action >> e.mods >> e.pointerPosition.x >> e.pointerPosition.y;
+        e.type = static_cast<InputEvent::Type>(type);
+    }
+    if(!file)
+    {
+        throw cogra::exceptions::RuntimeError(path + " is truncated or corrupt");
+    }
+    return recording;
+}
+
+LatencyStatistics computeLatencyStatistics(std::vector<float64> latencies)
+{
+    LatencyStatistics statistics;
+    statistics.nEvents = latencies.size();
+    if(latencies.empty())
+    {
+        return statistics;
+    }
+    statistics.maxMilliseconds = *std::max_element(latencies.begin(), latencies.end()) * 1e3;
+    statistics.p50Milliseconds = percentile(latencies, 0.50) * 1e3;
+    statistics.p99Milliseconds = percentile(latencies, 0.99) * 1e3;
+    return statistics;
+}
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cogra/types.h>
+#include <string>
+#include <vector>
+namespace cogra::ui
+{
+/// <summary>
+/// An input event of the viewport as received by BaseApp2D.
+/// </summary>
+struct InputEvent
+{
+    enum Type : int32 { MouseButton, CursorPosition, Key };
+
+    Type        type = CursorPosition;
+
+    //! Seconds since the start of the recording.
+    float64     time = 0.0;
+
+    //! Frame since the start of the recording in which the event was received.
+    uint64      frame = 0;
+
+    //! Button or key, action and modifiers. Unused for cursor positions.
+    int32       button = 0;
+
+    int32       action = 0;
+
+    int32       mods = 0;
+
+    //! Normalized pointer position when the event was received.
+    f64vec2     pointerPosition = f64vec2(0.0, 0.0);
+};
+
+/// <summary>
+/// Input events together with the scene they were applied to.
+/// </summary>
+struct InputRecording
+{
+    //! Framebuffer size during the recording. Pointer positions are normalized to it.
+    int32                       framebufferWidth = 0;
+
+    int32                       framebufferHeight = 0;
+
+    //! Application specific description of the initial scene.
+    std::string                 scene;
+
+    std::vector<InputEvent>     events;
+};
+
+/// <summary>
+/// Writes a recording as text. Throws on failure.
+/// </summary>
+void writeInputRecording(const std::string& path, const InputRecording& recording);
+
+/// <summary>
+/// Reads a recording written by writeInputRecording. Throws on failure.
+/// </summary>
+InputRecording readInputRecording(const std::string& path);
+
+/// <summary>
+/// Percentiles of the time from dispatching a replayed event to the end of the frame that shows it.
+/// </summary>
+struct LatencyStatistics
+{
+    size_t      nEvents = 0;
+
+    float64     p50Milliseconds = 0.0;
+
+    float64     p99Milliseconds = 0.0;
+
+    float64     maxMilliseconds = 0.0;
+};
+
+/// <summary>
+/// Computes the statistics of latencies given in seconds.
+/// </summary>
+LatencyStatistics computeLatencyStatistics(std::vector<float64> latencies);
+}
@@ -0,0 +1,97 @@
+#include "InstancedPolyLineDrawable.h"
+#include <cogra/gl/OpenGLRuntimeError.h>
+#include <utility>
+namespace cogra::gmca
+{
+InstancedPolyLineDrawable::InstancedPolyLineDrawable(const std::vector<f32vec2>& points)
+    : m_vertexArray(0)
+    , m_buffer(0)
+    , m_texture(0)
+    , m_nPoints(static_cast<GLsizei>(points.size()))
+{
+    // A core profile context refuses to draw without a bound vertex array, even if it holds no attributes.
+    GL_SAFE_CALL(glGenVertexArrays(1, &m_vertexArray));
+
+    GL_SAFE_CALL(glGenBuffers(1, &m_buffer));
+    GL_SAFE_CALL(glBindBuffer(GL_TEXTURE_BUFFER, m_buffer));
+    GL_SAFE_CALL(glBufferData(GL_TEXTURE_BUFFER, points.size() * sizeof(f32vec2), points.data(), GL_STATIC_DRAW));
+    GL_SAFE_CALL(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+
+    GL_SAFE_CALL(glGenTextures(1, &m_texture));
+    GL_SAFE_CALL(glBindTexture(GL_TEXTURE_BUFFER, m_texture));
+    GL_SAFE_CALL(glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, m_buffer));
+    GL_SAFE_CALL(glBindTexture(GL_TEXTURE_BUFFER, 0));
+}
+
+InstancedPolyLineDrawable::~InstancedPolyLineDrawable()
+{
+    release();
+}
+
+InstancedPolyLineDrawable::InstancedPolyLineDrawable(InstancedPolyLineDrawable&& other) noexcept
+    : m_vertexArray(std::exchange(other.m_vertexArray, 0))
+    , m_buffer(std::exchange(other.m_buffer, 0))
+    , m_texture(std::exchange(other.m_texture, 0))
+    , m_nPoints(std::exchange(other.m_nPoints, 0))
+{
+}
+
+InstancedPolyLineDrawable& InstancedPolyLineDrawable::operator=(InstancedPolyLineDrawable&& other) noexcept
+{
+    if(this != &other)
+    {
+        release();
+        m_vertexArray = std::exchange(other.m_vertexArray, 0);
+        m_buffer = std::exchange(other.m_buffer, 0);
+        m_texture = std::exchange(other.m_texture, 0);
+        m_nPoints = std::exchange(other.m_nPoints, 0);
+    }
+    return *this;
+}
+
+void InstancedPolyLineDrawable::drawSegments(uint32 textureUnit) const
+{
+    if(m_nPoints < 2)
+    {
+        return;
+    }
+    bind(textureUnit);
+    GL_SAFE_CALL(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_nPoints - 1));
+}
+
+void InstancedPolyLineDrawable::drawPoints(uint32 textureUnit) const
+{
+    if(m_nPoints < 1)
+    {
+        return;
+    }
+    bind(textureUnit);
+    GL_SAFE_CALL(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_nPoints));
+}
+
+void InstancedPolyLineDrawable::bind(uint32 textureUnit) const
+{
+    GL_SAFE_CALL(glBindVertexArray(m_vertexArray));
+    GL_SAFE_CALL(glActiveTexture(GL_TEXTURE0 + textureUnit));
+    GL_SAFE_CALL(glBindTexture(GL_TEXTURE_BUFFER, m_texture));
+}
+
+void InstancedPolyLineDrawable::release()
+{
+    if(m_texture != 0)
+    {
+        glDeleteTextures(1, &m_texture);
+    }
+    if(m_buffer != 0)
+    {
+        glDeleteBuffers(1, &m_buffer);
+    }
+    if(m_vertexArray != 0)
+    {
+        glDeleteVertexArrays(1, &m_vertexArray);
+    }
+    m_texture = 0;
+    m_buffer = 0;
+    m_vertexArray = 0;
+}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <glad/glad.h>
+#include <cogra/types.h>
+#include <vector>
+namespace cogra::gmca
+{
+/// <summary>
+/// GPU data for drawing a poly line as instanced quads instead of expanding it in a geometry shader.
+///
+/// The points are stored in a buffer texture. Segment i and point i are drawn as instance i of a
+/// four vertex triangle strip. The vertex shaders fetch the points by gl_InstanceID and compute
+/// the quad corners from gl_VertexID, so no vertex attributes are needed.
+/// </summary>
+class InstancedPolyLineDrawable
+{
+public:
+    explicit InstancedPolyLineDrawable(const std::vector<f32vec2>& points);
+
+    ~InstancedPolyLineDrawable();
+
+    InstancedPolyLineDrawable(const InstancedPolyLineDrawable&) = delete;
+
+    InstancedPolyLineDrawable& operator=(const InstancedPolyLineDrawable&) = delete;
+
+    InstancedPolyLineDrawable(InstancedPolyLineDrawable&& other) noexcept;
+
+    InstancedPolyLineDrawable& operator=(InstancedPolyLineDrawable&& other) noexcept;
+
+    /// <summary>
+    /// Draws one quad per line segment. The points are bound to the given texture unit.
+    /// </summary>
+    void drawSegments(uint32 textureUnit = 0) const;
+
+    /// <summary>
+    /// Draws one quad per point. The points are bound to the given texture unit.
+    /// </summary>
+    void drawPoints(uint32 textureUnit = 0) const;
+
+private:
+    void bind(uint32 textureUnit) const;
+
+    void release();
+
+    GLuint                  m_vertexArray;
+
+    GLuint                  m_buffer;
+
+    GLuint                  m_texture;
+
+    GLsizei                 m_nPoints;
+};
+}
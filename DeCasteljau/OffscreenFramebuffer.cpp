@@ -0,0 +1,104 @@
+#include "OffscreenFramebuffer.h"
+#include <cogra/gl/OpenGLRuntimeError.h>
+#include <cogra/exceptions/RuntimeError.h>
+#include <algorithm>
+namespace cogra::gmca
+{
+namespace
+{
+void createFramebuffer(uint32 width, uint32 height, uint32 nSamples, GLuint& framebuffer, GLuint& colorBuffer)
+{
+    GL_SAFE_CALL(glGenRenderbuffers(1, &colorBuffer));
+    GL_SAFE_CALL(glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer));
+    if(nSamples > 1)
+    {
+        GL_SAFE_CALL(glRenderbufferStorageMultisample(GL_RENDERBUFFER, nSamples, GL_RGBA8, width, height));
+    }
+    else
+    {
+        GL_SAFE_CALL(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height));
+    }
+    GL_SAFE_CALL(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+    GL_SAFE_CALL(glGenFramebuffers(1, &framebuffer));
+    GL_SAFE_CALL(glBindFramebuffer(GL_FRAMEBUFFER, framebuffer));
+    GL_SAFE_CALL(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer));
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    GL_SAFE_CALL(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    if(status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        throw cogra::exceptions::RuntimeError("Offscreen framebuffer is incomplete");
+    }
+}
+}
+
+OffscreenFramebuffer::OffscreenFramebuffer(uint32 width, uint32 height, uint32 nSamples)
+    : m_width(width)
+    , m_height(height)
+    , m_nSamples(nSamples)
+    , m_framebuffer(0)
+    , m_colorBuffer(0)
+    , m_resolveFramebuffer(0)
+    , m_resolveColorBuffer(0)
+{
+    createFramebuffer(width, height, nSamples, m_framebuffer, m_colorBuffer);
+    if(nSamples > 1)
+    {
+        createFramebuffer(width, height, 1, m_resolveFramebuffer, m_resolveColorBuffer);
+    }
+}
+
+OffscreenFramebuffer::~OffscreenFramebuffer()
+{
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteRenderbuffers(1, &m_colorBuffer);
+    if(m_resolveFramebuffer != 0)
+    {
+        glDeleteFramebuffers(1, &m_resolveFramebuffer);
+        glDeleteRenderbuffers(1, &m_resolveColorBuffer);
+    }
+}
+
+void OffscreenFramebuffer::bind() const
+{
+    GL_SAFE_CALL(glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer));
+    GL_SAFE_CALL(glViewport(0, 0, m_width, m_height));
+}
+
+Image OffscreenFramebuffer::read() const
+{
+    GLuint source = m_framebuffer;
+    if(m_resolveFramebuffer != 0)
+    {
+        GL_SAFE_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer));
+        GL_SAFE_CALL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_resolveFramebuffer));
+        GL_SAFE_CALL(glBlitFramebuffer(0, 0, m_width, m_height, 0, 0, m_width, m_height, GL_COLOR_BUFFER_BIT, GL_NEAREST));
+        source = m_resolveFramebuffer;
+    }
+
+    Image image(m_width, m_height, 3);
+    GL_SAFE_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, source));
+    GL_SAFE_CALL(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    GL_SAFE_CALL(glReadPixels(0, 0, m_width, m_height, GL_RGB, GL_UNSIGNED_BYTE, image.pixels.data()));
+    GL_SAFE_CALL(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+
+    // OpenGL returns the rows bottom to top.
+    const size_t rowSize = static_cast<size_t>(m_width) * 3;
+    for(uint32 y = 0; y < m_height / 2; y++)
+    {
+        std::swap_ranges(image.pixels.begin() + y * rowSize, image.pixels.begin() + (y + 1) * rowSize,
+            image.pixels.begin() + (m_height - 1 - y) * rowSize);
+    }
+    return image;
+}
+
+uint32 OffscreenFramebuffer::getWidth() const
+{
+    return m_width;
+}
+
+uint32 OffscreenFramebuffer::getHeight() const
+{
+    return m_height;
+}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <glad/glad.h>
+#include <cogra/types.h>
+#include "ImageIO.h"
+namespace cogra::gmca
+{
+/// <summary>
+/// A framebuffer object with an RGBA8 color attachment for rendering without a window.
+///
+/// With more than one sample the color attachment is multisampled and resolved into a single
+/// sampled framebuffer before reading.
+/// </summary>
+class OffscreenFramebuffer
+{
+public:
+    OffscreenFramebuffer(uint32 width, uint32 height, uint32 nSamples = 4);
+
+    ~OffscreenFramebuffer();
+
+    OffscreenFramebuffer(const OffscreenFramebuffer&) = delete;
+
+    OffscreenFramebuffer& operator=(const OffscreenFramebuffer&) = delete;
+
+    /// <summary>
+    /// Binds the framebuffer for drawing and sets the viewport to cover it.
+    /// </summary>
+    void bind() const;
+
+    /// <summary>
+    /// Reads the color attachment into an RGB image with rows ordered top to bottom.
+    /// </summary>
+    Image read() const;
+
+    uint32 getWidth() const;
+
+    uint32 getHeight() const;
+
+private:
+    uint32      m_width;
+
+    uint32      m_height;
+
+    uint32      m_nSamples;
+
+    GLuint      m_framebuffer;
+
+    GLuint      m_colorBuffer;
+
+    //! Single sampled framebuffer that the multisampled one is resolved into. Zero without multisampling.
+    GLuint      m_resolveFramebuffer;
+
+    GLuint      m_resolveColorBuffer;
+};
+}
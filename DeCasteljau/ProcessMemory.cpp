@@ -0,0 +1,35 @@
+#include "ProcessMemory.h"
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+namespace cogra::gmca
+{
+uint64 getPeakResidentBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+    return static_cast<uint64>(counters.PeakWorkingSetSize);
+#else
+    rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#if defined(__APPLE__)
+    // macOS reports bytes, Linux kilobytes.
+    return static_cast<uint64>(usage.ru_maxrss);
+#else
+    return static_cast<uint64>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+}
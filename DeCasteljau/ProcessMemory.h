@@ -0,0 +1,10 @@
+#pragma once
+#include <cogra/types.h>
+namespace cogra::gmca
+{
+/// <summary>
+/// Returns the largest amount of physical memory the process has used so far in bytes, or 0 if the platform does not report it.
+/// The value never decreases, so a measurement only shows the memory of an operation that exceeds all previous peaks.
+/// </summary>
+uint64 getPeakResidentBytes();
+}
@@ -0,0 +1,129 @@
+#include "SplineFitter.h"
+#include <algorithm>
+#include <cmath>
+namespace cogra::gmca
+{
+namespace
+{
+//! Number of points of the first fit of a segment.
+constexpr size_t MinFitSize = 4;
+}
+
+SplineFitter::SplineFitter(BezierSpline& spline, float32 tolerance)
+    : m_spline(spline)
+    , m_squaredTolerance(tolerance * tolerance)
+    , m_startTangent(0.0f, 0.0f)
+    , m_hasStartTangent(false)
+    , m_nextFitSize(MinFitSize)
+    , m_lastFitSize(0)
+    , m_nInputPoints(0)
+    , m_nSegments(0)
+{
+}
+
+void SplineFitter::addPoint(const f32vec2& point)
+{
+    m_nInputPoints++;
+    if(!m_points.empty() && m_points.back() == point)
+    {
+        return;
+    }
+    m_points.push_back(point);
+    if(m_points.size() >= m_nextFitSize)
+    {
+        fitBuffer(false);
+    }
+}
+
+void SplineFitter::finish()
+{
+    fitBuffer(true);
+    m_points.clear();
+    m_hasStartTangent = false;
+    m_lastFitSize = 0;
+    m_nextFitSize = MinFitSize;
+}
+
+size_t SplineFitter::getNumberOfInputPoints() const
+{
+    return m_nInputPoints;
+}
+
+size_t SplineFitter::getNumberOfSegments() const
+{
+    return m_nSegments;
+}
+
+void SplineFitter::fitBuffer(bool isFinal)
+{
+    while(m_points.size() >= m_nextFitSize || (isFinal && m_points.size() >= 2))
+    {
+        // Fits always cover a prefix of the buffer, so the points left over by a segment are fitted from MinFitSize points on again.
+        const size_t nPoints = std::min(m_nextFitSize, m_points.size());
+        CubicFit fit = fitCubic(m_points.data(), nPoints, getStartTangent(m_points.data(), nPoints), estimateEndTangent(m_points.data(), nPoints));
+        if(fit.maxSquaredError <= m_squaredTolerance)
+        {
+            m_lastFit = std::move(fit);
+            m_lastFitSize = nPoints;
+            if(nPoints < MaxPointsPerSegment && (!isFinal || nPoints < m_points.size()))
+            {
+                m_nextFitSize = nPoints + std::max<size_t>(nPoints / 2, 1);
+                continue;
+            }
+            emitSegment(m_lastFit.controlPoints);
+        }
+        else if(m_lastFitSize == 0)
+        {
+            // Not even the first fit of the segment met the tolerance. It covers at most MinFitSize points.
+            fitRecursively(0, nPoints);
+            m_lastFitSize = nPoints;
+        }
+        else
+        {
+            emitSegment(m_lastFit.controlPoints);
+        }
+
+        // The end point of the emitted segment starts the next one.
+        m_points.erase(m_points.begin(), m_points.begin() + (m_lastFitSize - 1));
+        m_lastFitSize = 0;
+        m_nextFitSize = MinFitSize;
+    }
+}
+
+void SplineFitter::emitSegment(const std::vector<f32vec2>& controlPoints)
+{
+    m_spline.addCurve(BezierCurve<f32vec2>(controlPoints));
+    m_nSegments++;
+
+    f32vec2 tangent = controlPoints[3] - controlPoints[2];
+    if(tangent.x == 0.0f && tangent.y == 0.0f)
+    {
+        tangent = controlPoints[3] - controlPoints[0];
+    }
+    const float32 l = std::sqrt(tangent.x * tangent.x + tangent.y * tangent.y);
+    m_hasStartTangent = l > 0.0f;
+    if(m_hasStartTangent)
+    {
+        m_startTangent = tangent / l;
+    }
+}
+
+void SplineFitter::fitRecursively(size_t first, size_t nPoints)
+{
+    const f32vec2* points = m_points.data() + first;
+    const CubicFit fit = fitCubic(points, nPoints, getStartTangent(points, nPoints), estimateEndTangent(points, nPoints));
+    if(fit.maxSquaredError <= m_squaredTolerance || nPoints < 3)
+    {
+        emitSegment(fit.controlPoints);
+        return;
+    }
+    const size_t split = std::clamp<size_t>(fit.maxErrorIndex, 1, nPoints - 2);
+    fitRecursively(first, split + 1);
+    fitRecursively(first + split, nPoints - split);
+}
+
+f32vec2 SplineFitter::getStartTangent(const f32vec2* points, size_t nPoints) const
+{
+    return m_hasStartTangent ? m_startTangent : estimateStartTangent(points, nPoints);
+}
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <cogra/types.h>
+#include <vector>
+#include "BezierSpline.h"
+#include "CubicFitting.h"
+namespace cogra::gmca
+{
+/// <summary>
+/// Fits a stream of densely sampled points (e.g. pen input) incrementally with cubic Bezier curves.
+///
+/// The points of the current segment are buffered. A growing prefix of the buffer is fitted, starting
+/// with a few points and growing by a constant factor after every fit. As soon as a fit exceeds the
+/// tolerance, the last fit that stayed within the tolerance is appended to the spline and the remaining
+/// points start the next segment, again with a short prefix. The fits of a segment thus form a geometric
+/// series bounded by a constant times its number of points, which bounds the amortized work per input
+/// point by a constant. Each segment starts with the end tangent of its predecessor, so the spline is
+/// tangent continuous at the joins.
+/// </summary>
+class SplineFitter
+{
+public:
+    /// <summary>
+    /// Creates a fitter that appends its segments to spline.
+    /// </summary>
+    /// <param name="spline">Receives the fitted segments.</param>
+    /// <param name="tolerance">Maximal distance between an input point and the fitted curve.</param>
+    SplineFitter(BezierSpline& spline, float32 tolerance);
+
+    /// <summary>
+    /// Consumes the next input point. May append segments to the spline.
+    /// </summary>
+    void addPoint(const f32vec2& point);
+
+    /// <summary>
+    /// Fits the buffered points, e.g. when the pen is lifted. Afterwards the fitter starts a new, unconnected stroke.
+    /// </summary>
+    void finish();
+
+    /// <summary>
+    /// Returns the number of points passed to addPoint.
+    /// </summary>
+    size_t getNumberOfInputPoints() const;
+
+    /// <summary>
+    /// Returns the number of segments appended to the spline.
+    /// </summary>
+    size_t getNumberOfSegments() const;
+
+private:
+    //! Upper bound for the number of points of a segment. Bounds the worst-case work of a single fit.
+    static constexpr size_t MaxPointsPerSegment = 4096;
+
+    /// <summary>
+    /// Fits prefixes of the buffer while it holds enough points and appends the finished segments.
+    /// </summary>
+    /// <param name="isFinal">If true, fits all buffered points, e.g. when the stroke ends.</param>
+    void fitBuffer(bool isFinal);
+
+    void emitSegment(const std::vector<f32vec2>& controlPoints);
+
+    /// <summary>
+    /// Fits m_points[0, nPoints) by recursive splitting at the point of maximal error.
+    /// Only used when not even the first, shortest fit of a segment met the tolerance, so nPoints is bounded by a constant.
+    /// </summary>
+    void fitRecursively(size_t first, size_t nPoints);
+
+    f32vec2 getStartTangent(const f32vec2* points, size_t nPoints) const;
+
+    BezierSpline&           m_spline;
+
+    float32                 m_squaredTolerance;
+
+    //! Points of the current segment. The first one is the end point of the previous segment.
+    std::vector<f32vec2>    m_points;
+
+    //! Unit end tangent of the previous segment, if the stroke has one.
+    f32vec2                 m_startTangent;
+
+    bool                    m_hasStartTangent;
+
+    //! Number of points of the next fit. The buffer is fitted again when it holds that many points.
+    size_t                  m_nextFitSize;
+
+    //! Last fit of a prefix of m_points that stayed within the tolerance.
+    CubicFit                m_lastFit;
+
+    //! Number of points covered by m_lastFit. Zero if there is none.
+    size_t                  m_lastFitSize;
+
+    size_t                  m_nInputPoints;
+
+    size_t                  m_nSegments;
+};
+}
@@ -0,0 +1,345 @@
+#include "SplineRasterizer.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <thread>
+#include <cogra/exceptions/RuntimeError.h>
+namespace cogra::gmca
+{
+namespace
+{
+//! Bounds the recursion of the flattening for degenerate curves.
+constexpr uint32 MaxFlatteningDepth = 16;
+
+struct Line
+{
+    f32vec2 p0;
+
+    f32vec2 p1;
+};
+
+f32vec2 transformPoint(const f32mat3& m, const f32vec2& p)
+{
+    const f32vec3 t = m * f32vec3(p.x, p.y, 1.0f);
+    return f32vec2(t.x, t.y);
+}
+
+/// <summary>
+/// Tests whether all inner control points are within the tolerance of the chord.
+/// </summary>
+bool isFlat(const std::vector<f32vec2>& controlPoints, float32 tolerance)
+{
+    const f32vec2 p0 = controlPoints.front();
+    const f32vec2 chord = controlPoints.back() - p0;
+    const float32 chordLength = std::sqrt(chord.x * chord.x + chord.y * chord.y);
+    for(size_t i = 1; i + 1 < controlPoints.size(); i++)
+    {
+        const f32vec2 d = controlPoints[i] - p0;
+        const float32 distance = (chordLength > 0.0f)
+            ? std::abs(chord.x * d.y - chord.y * d.x) / chordLength
+            : std::sqrt(d.x * d.x + d.y * d.y);
+        if(distance > tolerance)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void flatten(const BezierCurve<f32vec2>& curve, float32 tolerance, uint32 depth, std::vector<Line>& lines)
+{
+    const auto& controlPoints = curve.getCoefficients();
+    if(depth == MaxFlatteningDepth || isFlat(controlPoints, tolerance))
+    {
+        lines.push_back({ controlPoints.front(), controlPoints.back() });
+        return;
+    }
+    const auto halves = curve.subdivide();
+    flatten(halves.first, tolerance, depth + 1, lines);
+    flatten(halves.second, tolerance, depth + 1, lines);
+}
+
+/// <summary>
+/// Flattens all curves in pixel coordinates and closes open runs of curves.
+/// </summary>
+std::vector<Line> flattenSpline(const BezierSpline& spline, const f32mat3& transformation, float32 tolerance)
+{
+    std::vector<Line> lines;
+    f32vec2 runStart(0.0f, 0.0f);
+    const BezierCurve<f32vec2>* previous = nullptr;
+    for(const auto& curve : spline)
+    {
+        std::vector<f32vec2> controlPoints = curve.getCoefficients();
+        for(auto& p : controlPoints)
+        {
+            p = transformPoint(transformation, p);
+        }
+        if(!previous || previous->getCoefficients().back() != curve.getCoefficients().front())
+        {
+            if(previous && lines.back().p1 != runStart)
+            {
+                lines.push_back({ lines.back().p1, runStart });
+            }
+            runStart = controlPoints.front();
+        }
+        flatten(BezierCurve<f32vec2>(controlPoints), tolerance, 0, lines);
+        previous = &curve;
+    }
+    if(!lines.empty() && lines.back().p1 != runStart)
+    {
+        lines.push_back({ lines.back().p1, runStart });
+    }
+    return lines;
+}
+
+/// <summary>
+/// Accumulation buffer of a single tile. Each row has two extra cells because lines touching
+/// the right border write one cell past it.
+/// </summary>
+class TileAccumulator
+{
+public:
+    TileAccumulator(uint32 width, uint32 height)
+        : m_width(width)
+        , m_height(height)
+        , m_stride(width + 2)
+        , m_area(static_cast<size_t>(m_stride) * height, 0.0f)
+        , m_row(width, 0.0f)
+    {
+    }
+
+    void clear()
+    {
+        std::fill(m_area.begin(), m_area.end(), 0.0f);
+    }
+
+    /// <summary>
+    /// Clips a line in tile coordinates to the rows of the tile and clamps it horizontally to the tile.
+    /// Clamping after splitting at the borders keeps the area left of each pixel exact.
+    /// </summary>
+    void addLine(f32vec2 p0, f32vec2 p1)
+    {
+        if(p0.y == p1.y)
+        {
+            return;
+        }
+        const float32 h = static_cast<float32>(m_height);
+        const float32 w = static_cast<float32>(m_width);
+        const float32 dy = p1.y - p0.y;
+        const float32 t0 = std::clamp(((dy > 0.0f ? 0.0f : h) - p0.y) / dy, 0.0f, 1.0f);
+        const float32 t1 = std::clamp(((dy > 0.0f ? h : 0.0f) - p0.y) / dy, 0.0f, 1.0f);
+        if(t0 >= t1)
+        {
+            return;
+        }
+
+        float32 t[4] = { t0, t1, t1, t1 };
+        uint32 nSplits = 1;
+        const float32 dx = p1.x - p0.x;
+        if(dx != 0.0f)
+        {
+            for(const float32 border : { 0.0f, w })
+            {
+                const float32 s = (border - p0.x) / dx;
+                if(s > t0 && s < t1)
+                {
+                    t[nSplits++] = s;
+                }
+            }
+        }
+        t[nSplits] = t1;
+        if(nSplits == 3 && t[1] > t[2])
+        {
+            std::swap(t[1], t[2]);
+        }
+
+        const auto pointAt = [&](float32 s)
+        {
+            f32vec2 p = p0 + s * (p1 - p0);
+            p.x = std::clamp(p.x, 0.0f, w);
+            p.y = std::clamp(p.y, 0.0f, h);
+            return p;
+        };
+        for(uint32 i = 0; i < nSplits; i++)
+        {
+            accumulate(pointAt(t[i]), pointAt(t[i + 1]));
+        }
+    }
+
+    /// <summary>
+    /// Converts the accumulated area of one row into 8 bit coverage.
+    /// </summary>
+    void resolveRow(uint32 y, uint8* out)
+    {
+        const float32* area = &m_area[static_cast<size_t>(y) * m_stride];
+        float32 sum = 0.0f;
+        for(uint32 x = 0; x < m_width; x++)
+        {
+            sum += area[x];
+            m_row[x] = sum;
+        }
+        // Independent of the prefix sum, so the compiler can vectorize this loop.
+        for(uint32 x = 0; x < m_width; x++)
+        {
+            out[x] = static_cast<uint8>(std::min(std::abs(m_row[x]), 1.0f) * 255.0f + 0.5f);
+        }
+    }
+
+private:
+    /// <summary>
+    /// Adds the signed area covered right of a line to the cells it crosses, following font-rs.
+    /// Requires 0 &lt;= x &lt;= width and 0 &lt;= y &lt;= height.
+    /// </summary>
+    void accumulate(const f32vec2& a, const f32vec2& b)
+    {
+        if(a.y == b.y)
+        {
+            return;
+        }
+        const float32 direction = (a.y < b.y) ? 1.0f : -1.0f;
+        const f32vec2 p0 = (a.y < b.y) ? a : b;
+        const f32vec2 p1 = (a.y < b.y) ? b : a;
+        const float32 dxdy = (p1.x - p0.x) / (p1.y - p0.y);
+        float32 x = p0.x;
+        // Clamped before the cast, which is undefined for values beyond the range of uint32.
+        const uint32 yEnd = static_cast<uint32>(std::min(static_cast<float32>(m_height), std::ceil(p1.y)));
+        for(uint32 y = static_cast<uint32>(p0.y); y < yEnd; y++)
+        {
+            float32* row = &m_area[static_cast<size_t>(y) * m_stride];
+            const float32 dy = std::min(static_cast<float32>(y + 1), p1.y) - std::max(static_cast<float32>(y), p0.y);
+            // Clamped, as rounding may carry x across the borders.
+            const float32 xNext = std::clamp(x + dxdy * dy, 0.0f, static_cast<float32>(m_width));
+            const float32 d = dy * direction;
+            const float32 x0 = std::min(x, xNext);
+            const float32 x1 = std::max(x, xNext);
+            const float32 x0Floor = std::floor(x0);
+            const uint32 x0i = static_cast<uint32>(x0Floor);
+            const float32 x1Ceil = std::ceil(x1);
+            const uint32 x1i = static_cast<uint32>(x1Ceil);
+            if(x1i <= x0i + 1)
+            {
+                const float32 xm = 0.5f * (x + xNext) - x0Floor;
+                row[x0i] += d - d * xm;
+                row[x0i + 1] += d * xm;
+            }
+            else
+            {
+                const float32 s = 1.0f / (x1 - x0);
+                const float32 x0f = x0 - x0Floor;
+                const float32 a0 = 0.5f * s * (1.0f - x0f) * (1.0f - x0f);
+                const float32 x1f = x1 - x1Ceil + 1.0f;
+                const float32 am = 0.5f * s * x1f * x1f;
+                row[x0i] += d * a0;
+                if(x1i == x0i + 2)
+                {
+                    row[x0i + 1] += d * (1.0f - a0 - am);
+                }
+                else
+                {
+                    const float32 a1 = s * (1.5f - x0f);
+                    row[x0i + 1] += d * (a1 - a0);
+                    for(uint32 xi = x0i + 2; xi < x1i - 1; xi++)
+                    {
+                        row[xi] += d * s;
+                    }
+                    const float32 a2 = a1 + static_cast<float32>(x1i - x0i - 3) * s;
+                    row[x1i - 1] += d * (1.0f - a2 - am);
+                }
+                row[x1i] += d * am;
+            }
+            x = xNext;
+        }
+    }
+
+    uint32                  m_width;
+
+    uint32                  m_height;
+
+    uint32                  m_stride;
+
+    std::vector<float32>    m_area;
+
+    //! Prefix sums of the row that is resolved.
+    std::vector<float32>    m_row;
+};
+}
+
+Image rasterizeSpline(const BezierSpline& spline, const f32mat3& transformation, uint32 width, uint32 height,
+    const RasterizerOptions& options)
+{
+    if(options.tileSize == 0)
+    {
+        throw cogra::exceptions::RuntimeError("The tile size must be positive");
+    }
+
+    Image image(width, height, 1);
+    const std::vector<Line> lines = flattenSpline(spline, transformation, options.flatteningTolerance);
+
+    // Bin the lines into bands of tile rows. Tiles of a band test only the lines of their band.
+    const uint32 tileSize = options.tileSize;
+    const uint32 nTilesX = (width + tileSize - 1) / tileSize;
+    const uint32 nTilesY = (height + tileSize - 1) / tileSize;
+    std::vector<std::vector<uint32>> bands(nTilesY);
+    for(uint32 i = 0; i < lines.size(); i++)
+    {
+        const float32 yMin = std::min(lines[i].p0.y, lines[i].p1.y);
+        const float32 yMax = std::max(lines[i].p0.y, lines[i].p1.y);
+        if(yMin == yMax || yMax <= 0.0f || yMin >= static_cast<float32>(height))
+        {
+            continue;
+        }
+        // Clamped in float before the casts, which are undefined for values beyond the range of uint32.
+        const uint32 first = static_cast<uint32>(std::max(0.0f, yMin)) / tileSize;
+        const uint32 last = std::min(nTilesY - 1, static_cast<uint32>(std::min(static_cast<float32>(height), std::ceil(yMax))) / tileSize);
+        for(uint32 b = first; b <= last; b++)
+        {
+            bands[b].push_back(i);
+        }
+    }
+
+    std::atomic<uint32> nextTile(0);
+    const auto rasterizeTiles = [&]()
+    {
+        TileAccumulator accumulator(tileSize, tileSize);
+        std::vector<uint8> row(tileSize);
+        for(uint32 tile = nextTile++; tile < nTilesX * nTilesY; tile = nextTile++)
+        {
+            const uint32 tileX = (tile % nTilesX) * tileSize;
+            const uint32 tileY = (tile / nTilesX) * tileSize;
+            const f32vec2 origin(static_cast<float32>(tileX), static_cast<float32>(tileY));
+            const float32 right = origin.x + static_cast<float32>(tileSize);
+            accumulator.clear();
+            for(const uint32 i : bands[tile / nTilesX])
+            {
+                // Lines right of the tile cannot change the winding inside.
+                if(std::min(lines[i].p0.x, lines[i].p1.x) < right)
+                {
+                    accumulator.addLine(lines[i].p0 - origin, lines[i].p1 - origin);
+                }
+            }
+
+            const uint32 tileWidth = std::min(tileSize, width - tileX);
+            const uint32 tileHeight = std::min(tileSize, height - tileY);
+            for(uint32 y = 0; y < tileHeight; y++)
+            {
+                accumulator.resolveRow(y, row.data());
+                std::copy(row.begin(), row.begin() + tileWidth, image.pixels.begin() + static_cast<size_t>(tileY + y) * width + tileX);
+            }
+        }
+    };
+
+    const uint32 nThreads = std::max<uint32>(1, std::min(options.nThreads > 0 ? options.nThreads : std::thread::hardware_concurrency(), nTilesX * nTilesY));
+    std::vector<std::future<void>> tasks;
+    for(uint32 t = 1; t < nThreads; t++)
+    {
+        tasks.push_back(std::async(std::launch::async, rasterizeTiles));
+    }
+    rasterizeTiles();
+    for(auto& task : tasks)
+    {
+        task.get();
+    }
+    return image;
+}
+}
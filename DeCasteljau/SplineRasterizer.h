@@ -0,0 +1,39 @@
+#pragma once
+#include <cogra/types.h>
+#include "BezierSpline.h"
+#include "ImageIO.h"
+namespace cogra::gmca
+{
+/// <summary>
+/// Settings of the CPU rasterizer.
+/// </summary>
+struct RasterizerOptions
+{
+    //! Width and height of the square screen tiles that are processed independently.
+    uint32      tileSize = 64;
+
+    //! Number of worker threads. 0 uses one thread per hardware thread.
+    uint32      nThreads = 0;
+
+    //! Maximal distance in pixels between a curve and its flattened poly line.
+    float32     flatteningTolerance = 0.1f;
+};
+
+/// <summary>
+/// Fills the region enclosed by the spline with the nonzero winding rule into a one channel coverage image.
+///
+/// Curves are flattened into line segments by recursive subdivision. Each line adds its signed area to an
+/// accumulation buffer and a prefix sum along each row yields the coverage, which gives exact area
+/// antialiasing. The image is split into tiles that threads rasterize independently. Lines left of a tile are
+/// clamped to its left border, where they contribute the winding that flows into the tile.
+///
+/// Runs of adjacent curves whose end point does not meet their start point are closed by a line.
+/// </summary>
+/// <param name="spline">The outlines.</param>
+/// <param name="transformation">Maps curve coordinates to pixel coordinates. The y axis points downwards.</param>
+/// <param name="width">Width of the image in pixels.</param>
+/// <param name="height">Height of the image in pixels.</param>
+/// <param name="options">Tiling, threading and flattening settings.</param>
+Image rasterizeSpline(const BezierSpline& spline, const f32mat3& transformation, uint32 width, uint32 height,
+    const RasterizerOptions& options = RasterizerOptions());
+}
@@ -0,0 +1,223 @@
+#include "SplineRenderer.h"
+#include <algorithm>
+#include <cogra/gl/OpenGLRuntimeError.h>
+using cogra::graphics::drawable::PolyLineDrawable;
+namespace cogra::gmca
+{
+SplineRenderer::SplineRenderer(const std::string& shaderDirectory)
+    : m_drawCurveProgram(shaderDirectory + "drawCurve.vert.glsl", shaderDirectory + "drawCurve.geom.glsl", shaderDirectory + "drawCurve.frag.glsl")
+    , m_drawPointsProgram(shaderDirectory + "drawPoints.vert.glsl", shaderDirectory + "drawPoints.geom.glsl", shaderDirectory + "drawPoints.frag.glsl")
+    , m_drawCurveInstancedProgram(shaderDirectory + "drawCurveInstanced.vert.glsl", shaderDirectory + "drawCurveInstanced.frag.glsl")
+    , m_drawPointsInstancedProgram(shaderDirectory + "drawPointsInstanced.vert.glsl", shaderDirectory + "drawPoints.frag.glsl")
+    , m_drawCurveDistanceProgram(shaderDirectory + "drawCurveDistance.vert.glsl", shaderDirectory + "drawCurveDistance.frag.glsl")
+    , m_renderPath(GeometryShader)
+{
+}
+
+void SplineRenderer::setRenderPath(RenderPath renderPath)
+{
+    m_renderPath = renderPath;
+    m_lineDrawable.clear();
+    m_controlNetMesh.clear();
+    m_instancedLineDrawable.clear();
+    m_instancedControlNetMesh.clear();
+    m_curvesDrawable.clear();
+}
+
+SplineRenderer::RenderPath SplineRenderer::getRenderPath() const
+{
+    return m_renderPath;
+}
+
+void SplineRenderer::updateCurves(const std::vector<std::vector<f32vec2>>& sampledCurves)
+{
+    m_lineDrawable.clear();
+    m_instancedLineDrawable.clear();
+    for(const auto& sampledPoints : sampledCurves)
+    {
+        if(m_renderPath == Instanced)
+        {
+            m_instancedLineDrawable.emplace_back(sampledPoints);
+        }
+        else if(m_renderPath == GeometryShader)
+        {
+            m_lineDrawable.emplace_back(sampledPoints);
+            m_lineDrawable.back().setPrimitiveType(PolyLineDrawable::LineStrip);
+        }
+    }
+}
+
+void SplineRenderer::updateControlNets(const BezierSpline& spline)
+{
+    m_controlNetMesh.clear();
+    m_instancedControlNetMesh.clear();
+    m_curvesDrawable.clear();
+    if(m_renderPath == SignedDistance)
+    {
+        m_curvesDrawable.emplace_back(spline);
+    }
+    for(const auto& curve : spline)
+    {
+        if(m_renderPath != GeometryShader)
+        {
+            m_instancedControlNetMesh.emplace_back(curve.getCoefficients());
+        }
+        else
+        {
+            m_controlNetMesh.emplace_back(curve.getCoefficients());
+            m_controlNetMesh.back().setPrimitiveType(PolyLineDrawable::LineStrip);
+        }
+    }
+}
+
+void SplineRenderer::draw(const f32mat3& transformation, const f32vec2& framebufferSize, const Style& style)
+{
+    const auto pixelScale = 2.0f / std::min(framebufferSize.x, framebufferSize.y);
+    const auto radius = 0.5f * style.controlPointSize * f32vec2(2.0f / framebufferSize.x, 2.0f / framebufferSize.y);
+    if(m_renderPath != GeometryShader)
+    {
+        drawInstanced(transformation, pixelScale, radius, style);
+    }
+    else
+    {
+        drawWithGeometryShader(transformation, pixelScale, radius, style);
+    }
+}
+
+void SplineRenderer::drawLines(PolyLineDrawable& lines, const f32mat3& transformation, float32 halfLineWidth, const f32vec3& color)
+{
+    m_drawCurveProgram.use();
+    m_drawCurveProgram.setUniform("u_color", color);
+    m_drawCurveProgram.setUniform("u_halfLineWidth", halfLineWidth);
+    m_drawCurveProgram.setUniform("u_transformationMatrix", transformation);
+    lines.setPrimitiveType(PolyLineDrawable::LineStripAdjacency);
+    lines.draw();
+}
+
+void SplineRenderer::drawPoints(PolyLineDrawable& points, const f32mat3& transformation, const f32vec2& radius, const f32vec3& color)
+{
+    m_drawPointsProgram.use();
+    m_drawPointsProgram.setUniform("u_transformationMatrix", transformation);
+    m_drawPointsProgram.setUniform("u_color", color);
+    m_drawPointsProgram.setUniform("u_radius", radius);
+    points.setPrimitiveType(PolyLineDrawable::Points);
+    points.draw();
+}
+
+void SplineRenderer::drawWithGeometryShader(const f32mat3& transformation, float32 pixelScale, const f32vec2& radius, const Style& style)
+{
+    if(style.showControlPoints)
+    {
+        for(auto& c : m_controlNetMesh)
+        {
+            drawPoints(c, transformation, radius, style.controlPointColor);
+        }
+    }
+
+    if(style.showControlPolygon)
+    {
+        for(auto& c : m_controlNetMesh)
+        {
+            drawLines(c, transformation, 0.5f * style.controlPolygonLineWidth * pixelScale, style.controlPolygonColor);
+        }
+    }
+
+    if(style.showCurve)
+    {
+        for(auto& l : m_lineDrawable)
+        {
+            drawLines(l, transformation, 0.5f * style.curveLineWidth * pixelScale, style.curveColor);
+        }
+    }
+}
+
+void SplineRenderer::drawInstanced(const f32mat3& transformation, float32 pixelScale, const f32vec2& radius, const Style& style)
+{
+    if(style.showControlPoints)
+    {
+        m_drawPointsInstancedProgram.use();
+        m_drawPointsInstancedProgram.setUniform("u_points", 0);
+        m_drawPointsInstancedProgram.setUniform("u_transformationMatrix", transformation);
+        m_drawPointsInstancedProgram.setUniform("u_color", style.controlPointColor);
+        m_drawPointsInstancedProgram.setUniform("u_radius", radius);
+        for(const auto& c : m_instancedControlNetMesh)
+        {
+            c.drawPoints();
+        }
+    }
+
+    if(style.showControlPolygon)
+    {
+        m_drawCurveInstancedProgram.use();
+        m_drawCurveInstancedProgram.setUniform("u_points", 0);
+        m_drawCurveInstancedProgram.setUniform("u_color", style.controlPolygonColor);
+        m_drawCurveInstancedProgram.setUniform("u_transformationMatrix", transformation);
+        m_drawCurveInstancedProgram.setUniform("u_halfLineWidth", 0.5f * style.controlPolygonLineWidth * pixelScale);
+        for(const auto& c : m_instancedControlNetMesh)
+        {
+            c.drawSegments();
+        }
+    }
+
+    if(style.showCurve && m_renderPath == SignedDistance)
+    {
+        drawCurvesBySignedDistance(transformation, pixelScale, style);
+    }
+    else if(style.showCurve)
+    {
+        m_drawCurveInstancedProgram.use();
+        m_drawCurveInstancedProgram.setUniform("u_points", 0);
+        m_drawCurveInstancedProgram.setUniform("u_transformationMatrix", transformation);
+        m_drawCurveInstancedProgram.setUniform("u_color", style.curveColor);
+        m_drawCurveInstancedProgram.setUniform("u_halfLineWidth", 0.5f * style.curveLineWidth * pixelScale);
+        for(const auto& l : m_instancedLineDrawable)
+        {
+            l.drawSegments();
+        }
+    }
+}
+
+void SplineRenderer::drawCurvesBySignedDistance(const f32mat3& transformation, float32 pixelScale, const Style& style)
+{
+    m_drawCurveDistanceProgram.use();
+    m_drawCurveDistanceProgram.setUniform("u_controlPoints", 0);
+    m_drawCurveDistanceProgram.setUniform("u_transformationMatrix", transformation);
+    m_drawCurveDistanceProgram.setUniform("u_color", style.curveColor);
+    m_drawCurveDistanceProgram.setUniform("u_halfLineWidth", 0.5f * style.curveLineWidth * pixelScale);
+    m_drawCurveDistanceProgram.setUniform("u_pixelScale", pixelScale);
+
+    // The quads of neighboring curves overlap at their joins. Blending the coverage of every quad would darken
+    // the joins, so the coverage pass first combines it in the alpha channel by maximum. The resolve pass then
+    // blends the color once per pixel with that coverage and resets it to zero, which leaves later quads without effect.
+    float32 clearColor[4];
+    GL_SAFE_CALL(glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor));
+    GL_SAFE_CALL(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE));
+    GL_SAFE_CALL(glClearColor(0.0f, 0.0f, 0.0f, 0.0f));
+    GL_SAFE_CALL(glClear(GL_COLOR_BUFFER_BIT));
+
+    GL_SAFE_CALL(glEnable(GL_BLEND));
+    GL_SAFE_CALL(glBlendEquation(GL_MAX));
+    m_drawCurveDistanceProgram.setUniform("u_isResolvePass", false);
+    for(const auto& c : m_curvesDrawable)
+    {
+        c.draw();
+    }
+
+    GL_SAFE_CALL(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+    GL_SAFE_CALL(glBlendEquation(GL_FUNC_ADD));
+    GL_SAFE_CALL(glBlendFuncSeparate(GL_DST_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ZERO, GL_ZERO));
+    m_drawCurveDistanceProgram.setUniform("u_isResolvePass", true);
+    for(const auto& c : m_curvesDrawable)
+    {
+        c.draw();
+    }
+    GL_SAFE_CALL(glDisable(GL_BLEND));
+
+    // The framebuffer is opaque again.
+    GL_SAFE_CALL(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_TRUE));
+    GL_SAFE_CALL(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    GL_SAFE_CALL(glClear(GL_COLOR_BUFFER_BIT));
+    GL_SAFE_CALL(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+    GL_SAFE_CALL(glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]));
+}
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include <cogra/types.h>
+#include <cogra/gl/GLSLProgram.h>
+#include <cogra/graphics/drawable/PolyLineDrawable.h>
+#include <string>
+#include <vector>
+#include "BezierCurve.h"
+#include "BezierSpline.h"
+#include "BezierCurvesDrawable.h"
+#include "InstancedPolyLineDrawable.h"
+namespace cogra::gmca
+{
+/// <summary>
+/// Draws the curves of a spline together with their control polygons and control points.
+///
+/// Holds the GPU programs and the GPU data, but knows nothing about windows or user input,
+/// so it is shared by the interactive app and the headless exporter.
+/// </summary>
+class SplineRenderer
+{
+public:
+    //! A type for selecting how lines and points are expanded to triangles. SignedDistance draws
+    //! the curves from their control points and computes the distance to them per fragment.
+    enum RenderPath : int32 { GeometryShader, Instanced, SignedDistance };
+
+    /// <summary>
+    /// Appearance of the spline. Widths and sizes are given in pixels.
+    /// </summary>
+    struct Style
+    {
+        bool showCurve = true;
+
+        bool showControlPolygon = true;
+
+        bool showControlPoints = true;
+
+        float32 curveLineWidth = 16.0f;
+
+        float32 controlPolygonLineWidth = 10.0f;
+
+        float32 controlPointSize = 32;
+
+        f32vec3 curveColor = f32vec3(0.0f, 0.0f, 0.0f);
+
+        f32vec3 controlPolygonColor = f32vec3(0.5f, 0.5f, 0.5f);
+
+        f32vec3 controlPointColor = f32vec3(0.5f, 0.5f, 0.5f);
+    };
+
+    /// <summary>
+    /// Loads the GPU programs. Requires a current OpenGL context.
+    /// </summary>
+    /// <param name="shaderDirectory">Directory with the shaders including a trailing slash.</param>
+    explicit SplineRenderer(const std::string& shaderDirectory = "../shaders/");
+
+    /// <summary>
+    /// Selects the render path. Uploaded data of the previous path is discarded, so call
+    /// updateCurves and updateControlNets afterwards.
+    /// </summary>
+    void setRenderPath(RenderPath renderPath);
+
+    RenderPath getRenderPath() const;
+
+    /// <summary>
+    /// Uploads sampled curves, one poly line per curve. Not needed by the signed distance path.
+    /// </summary>
+    void updateCurves(const std::vector<std::vector<f32vec2>>& sampledCurves);
+
+    /// <summary>
+    /// Uploads the control points of the curves. The signed distance path draws the curves from them as well.
+    /// </summary>
+    void updateControlNets(const BezierSpline& spline);
+
+    /// <summary>
+    /// Draws control points, control polygons and curves.
+    /// </summary>
+    /// <param name="transformation">Maps curve coordinates to normalized device coordinates.</param>
+    /// <param name="framebufferSize">Size of the framebuffer in pixels.</param>
+    /// <param name="style">The appearance.</param>
+    void draw(const f32mat3& transformation, const f32vec2& framebufferSize, const Style& style);
+
+    /// <summary>
+    /// Draws a poly line with the geometry shader path.
+    /// </summary>
+    void drawLines(cogra::graphics::drawable::PolyLineDrawable& lines, const f32mat3& transformation, float32 halfLineWidth, const f32vec3& color);
+
+    /// <summary>
+    /// Draws the points of a poly line with the geometry shader path.
+    /// </summary>
+    void drawPoints(cogra::graphics::drawable::PolyLineDrawable& points, const f32mat3& transformation, const f32vec2& radius, const f32vec3& color);
+
+private:
+    void drawWithGeometryShader(const f32mat3& transformation, float32 pixelScale, const f32vec2& radius, const Style& style);
+
+    void drawInstanced(const f32mat3& transformation, float32 pixelScale, const f32vec2& radius, const Style& style);
+
+    void drawCurvesBySignedDistance(const f32mat3& transformation, float32 pixelScale, const Style& style);
+
+    //! The GPU program that draws the curve.
+    cogra::gl::GLSLProgram                                      m_drawCurveProgram;
+
+    //! The GPU program that draws the points
+    cogra::gl::GLSLProgram                                      m_drawPointsProgram;
+
+    //! Draws line segments as instanced quads without a geometry shader.
+    cogra::gl::GLSLProgram                                      m_drawCurveInstancedProgram;
+
+    //! Draws points as instanced quads without a geometry shader.
+    cogra::gl::GLSLProgram                                      m_drawPointsInstancedProgram;
+
+    //! Draws curves by their distance to the fragments.
+    cogra::gl::GLSLProgram                                      m_drawCurveDistanceProgram;
+
+    RenderPath                                                  m_renderPath;
+
+    //! The drawable that holds GPU data for drawing the curve.
+    std::vector<cogra::graphics::drawable::PolyLineDrawable>    m_lineDrawable;
+
+    std::vector<cogra::graphics::drawable::PolyLineDrawable>    m_controlNetMesh;
+
+    //! Counterparts of m_lineDrawable and m_controlNetMesh for the instanced render path.
+    std::vector<InstancedPolyLineDrawable>                      m_instancedLineDrawable;
+
+    std::vector<InstancedPolyLineDrawable>                      m_instancedControlNetMesh;
+
+    //! All curves for the signed distance path. Empty for the other paths.
+    std::vector<BezierCurvesDrawable>                           m_curvesDrawable;
+};
+}
@@ -74,6 +74,11 @@ cogra::float32 TransformationController2D::getScaleFactor() const
 {
     return m_scaleFactor;
 }
+void TransformationController2D::setView(const cogra::f32vec2& translation, cogra::float32 scaleFactor)
+{
+    m_translationVector = translation;
+    m_scaleFactor = scaleFactor;
+}
 cogra::f32mat3 TransformationController2D::translationMatrix() const
 {
     return cogra::f32mat3(1, 0, 0,
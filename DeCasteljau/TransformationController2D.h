@@ -23,6 +23,11 @@ public:
 
     cogra::float32 getScaleFactor() const;
 
+    /// <summary>
+    /// Replaces translation and scale factor of the transformation.
+    /// </summary>
+    void setView(const cogra::f32vec2& translation, cogra::float32 scaleFactor);
+
 private:
     cogra::f32mat3 translationMatrix() const;
 
@@ -0,0 +1,315 @@
+#version 400 core
+#pragma optimize(on)
+
+const int MaxControlPoints = 7;
+const int TexelsPerCurve = MaxControlPoints + 1;
+
+// Lines and quadratics are solved in closed form. For higher degrees, the local minima of the squared distance
+// are isolated as roots of its derivative (B(t) - p) . B'(t), a polynomial of degree 2n - 1, by subdividing its
+// Bernstein form until each interval holds a single sign change. Newton's method safeguarded by bisection then
+// refines every root at which the derivative changes from negative to positive.
+const int MaxDerivativeCoefficients = 2 * MaxControlPoints - 2;
+const int MaxSubdivisionDepth = 12;
+const int NumberOfRefinementSteps = 8;
+
+const float Pi = 3.14159265;
+
+uniform samplerBuffer u_controlPoints;
+uniform float u_halfLineWidth;
+uniform vec3 u_color;
+
+// The coverage pass writes the coverage of every fragment, which is combined per pixel by maximum.
+// The resolve pass only outputs the color, which is blended once per pixel with that coverage.
+uniform bool u_isResolvePass;
+
+in vec2 curvePosition;
+flat in int curveIndex;
+out vec4 fragColor;
+
+vec2 controlPoints[MaxControlPoints];
+int nControlPoints = 0;
+
+// Position, first and second derivative at t by de Casteljau's algorithm.
+void evaluate(float t, out vec2 position, out vec2 firstDerivative, out vec2 secondDerivative)
+{
+    vec2 b[MaxControlPoints];
+    for(int i = 0; i < nControlPoints; i++)
+    {
+        b[i] = controlPoints[i];
+    }
+
+    int degree = nControlPoints - 1;
+    for(int level = degree; level > 2; level--)
+    {
+        for(int i = 0; i < level; i++)
+        {
+            b[i] = mix(b[i], b[i + 1], t);
+        }
+    }
+
+    secondDerivative = vec2(0.0);
+    if(degree >= 2)
+    {
+        secondDerivative = float(degree * (degree - 1)) * (b[2] - 2.0 * b[1] + b[0]);
+        b[0] = mix(b[0], b[1], t);
+        b[1] = mix(b[1], b[2], t);
+    }
+
+    firstDerivative = vec2(0.0);
+    position = b[0];
+    if(degree >= 1)
+    {
+        firstDerivative = float(degree) * (b[1] - b[0]);
+        position = mix(b[0], b[1], t);
+    }
+}
+
+float squaredDistanceToQuadraticAt(vec2 p0, vec2 a, vec2 b, float t)
+{
+    vec2 r = p0 + (2.0 * a + b * t) * t - curvePosition;
+    return dot(r, r);
+}
+
+// Squared distance to the quadratic p0 + 2 a t + b t^2 with a = p1 - p0 and b = p0 - 2 p1 + p2.
+// The closest point is a root of the cubic (B(t) - p) . B'(t) = 0, which is solved by Cardano's formula.
+float squaredDistanceToQuadratic(vec2 p0, vec2 p1, vec2 p2)
+{
+    vec2 a = p1 - p0;
+    vec2 b = p0 - 2.0 * p1 + p2;
+    vec2 d = p0 - curvePosition;
+    float squaredDistance = min(dot(d, d), dot(p2 - curvePosition, p2 - curvePosition));
+
+    float c3 = dot(b, b);
+    float c2 = 3.0 * dot(a, b);
+    float c1 = 2.0 * dot(a, a) + dot(d, b);
+    float c0 = dot(d, a);
+
+    // Degenerate to a line traversed with constant speed, or to a point.
+    if(c3 <= 1e-12 * max(dot(a, a), 1e-30))
+    {
+        if(c1 > 0.0)
+        {
+            squaredDistance = min(squaredDistance, squaredDistanceToQuadraticAt(p0, a, b, clamp(-c0 / c1, 0.0, 1.0)));
+        }
+        return squaredDistance;
+    }
+
+    // t = x - A / 3 turns t^3 + A t^2 + B t + C into the depressed cubic x^3 + p x + q.
+    float A = c2 / c3;
+    float B = c1 / c3;
+    float C = c0 / c3;
+    float p = B - A * A / 3.0;
+    float q = A * (2.0 * A * A - 9.0 * B) / 27.0 + C;
+    float discriminant = 0.25 * q * q + p * p * p / 27.0;
+
+    vec3 roots;
+    int nRoots;
+    if(discriminant >= 0.0)
+    {
+        float s = sqrt(discriminant);
+        float u = -0.5 * q + s;
+        float v = -0.5 * q - s;
+        roots.x = sign(u) * pow(abs(u), 1.0 / 3.0) + sign(v) * pow(abs(v), 1.0 / 3.0);
+        nRoots = 1;
+    }
+    else
+    {
+        float m = 2.0 * sqrt(-p / 3.0);
+        float phi = acos(clamp(3.0 * q / (p * m), -1.0, 1.0)) / 3.0;
+        roots = m * cos(vec3(phi, phi - 2.0 * Pi / 3.0, phi - 4.0 * Pi / 3.0));
+        nRoots = 3;
+    }
+
+    for(int i = 0; i < nRoots; i++)
+    {
+        // One Newton step on the cubic recovers the precision lost by the cancellation in the formulas.
+        float t = roots[i] - A / 3.0;
+        float f = ((t + A) * t + B) * t + C;
+        float df = (3.0 * t + 2.0 * A) * t + B;
+        if(df != 0.0)
+        {
+            t -= f / df;
+        }
+        squaredDistance = min(squaredDistance, squaredDistanceToQuadraticAt(p0, a, b, clamp(t, 0.0, 1.0)));
+    }
+    return squaredDistance;
+}
+
+// Squared distance at the local minimum of the squared distance in [lower, upper], at whose ends
+// the derivative (B(t) - p) . B'(t) is negative and positive.
+float refineMinimum(float lower, float upper)
+{
+    vec2 p;
+    vec2 d1;
+    vec2 d2;
+    float t = 0.5 * (lower + upper);
+    float squaredDistance = 1e30;
+    for(int i = 0; i < NumberOfRefinementSteps; i++)
+    {
+        evaluate(t, p, d1, d2);
+        vec2 r = p - curvePosition;
+        squaredDistance = min(squaredDistance, dot(r, r));
+        float derivative = dot(r, d1);
+        if(derivative < 0.0)
+        {
+            lower = t;
+        }
+        else
+        {
+            upper = t;
+        }
+        // Bisect whenever the Newton step leaves the bracket.
+        float denominator = dot(d1, d1) + dot(r, d2);
+        float next = (denominator > 0.0) ? t - derivative / denominator : -1.0;
+        t = (next >= lower && next <= upper) ? next : 0.5 * (lower + upper);
+    }
+    evaluate(t, p, d1, d2);
+    return min(squaredDistance, dot(p - curvePosition, p - curvePosition));
+}
+
+// Bernstein coefficients of (B(t) - p) . B'(t), the product of B(t) - p and the hodograph.
+int computeDerivativeCoefficients(out float c[MaxDerivativeCoefficients])
+{
+    int n = nControlPoints - 1;
+    int m = 2 * n - 1;
+    for(int k = 0; k <= m; k++)
+    {
+        c[k] = 0.0;
+    }
+    float binomialI = 1.0;
+    for(int i = 0; i <= n; i++)
+    {
+        vec2 q = controlPoints[i] - curvePosition;
+        float binomialJ = 1.0;
+        for(int j = 0; j < n; j++)
+        {
+            vec2 d = float(n) * (controlPoints[j + 1] - controlPoints[j]);
+            c[i + j] += binomialI * binomialJ * dot(q, d);
+            binomialJ *= float(n - 1 - j) / float(j + 1);
+        }
+        binomialI *= float(n - i) / float(i + 1);
+    }
+    float binomialK = 1.0;
+    for(int k = 0; k <= m; k++)
+    {
+        c[k] /= binomialK;
+        binomialK *= float(m - k) / float(k + 1);
+    }
+    return m + 1;
+}
+
+float squaredDistanceToCurveOfHigherDegree()
+{
+    vec2 first = controlPoints[0] - curvePosition;
+    vec2 last = controlPoints[nControlPoints - 1] - curvePosition;
+    float squaredDistance = min(dot(first, first), dot(last, last));
+
+    float c[MaxDerivativeCoefficients];
+    int nCoefficients = computeDerivativeCoefficients(c);
+
+    // Depth first subdivision with an explicit stack. Every level adds at most one interval to it.
+    float stackCoefficients[MaxDerivativeCoefficients * (MaxSubdivisionDepth + 1)];
+    float stackLower[MaxSubdivisionDepth + 1];
+    int stackDepth[MaxSubdivisionDepth + 1];
+    for(int k = 0; k < nCoefficients; k++)
+    {
+        stackCoefficients[k] = c[k];
+    }
+    stackLower[0] = 0.0;
+    stackDepth[0] = 0;
+    int top = 1;
+    while(top > 0)
+    {
+        top--;
+        for(int k = 0; k < nCoefficients; k++)
+        {
+            c[k] = stackCoefficients[top * MaxDerivativeCoefficients + k];
+        }
+        float lower = stackLower[top];
+        int depth = stackDepth[top];
+        float upper = lower + exp2(-float(depth));
+
+        // The number of sign changes of the coefficients bounds the number of roots in the interval.
+        int nSignChanges = 0;
+        for(int k = 0; k + 1 < nCoefficients; k++)
+        {
+            if((c[k] < 0.0) != (c[k + 1] < 0.0))
+            {
+                nSignChanges++;
+            }
+        }
+        if(nSignChanges == 0)
+        {
+            continue;
+        }
+        if(nSignChanges == 1 || depth == MaxSubdivisionDepth)
+        {
+            // The end coefficients are the values of the derivative at the ends of the interval.
+            if(c[0] < 0.0 && c[nCoefficients - 1] >= 0.0)
+            {
+                squaredDistance = min(squaredDistance, refineMinimum(lower, upper));
+            }
+            continue;
+        }
+
+        // De Casteljau at 1/2: the left half replaces the interval, the right half is pushed on top of it.
+        int left = top * MaxDerivativeCoefficients;
+        int right = (top + 1) * MaxDerivativeCoefficients;
+        for(int level = 0; level < nCoefficients; level++)
+        {
+            stackCoefficients[left + level] = c[0];
+            stackCoefficients[right + nCoefficients - 1 - level] = c[nCoefficients - 1 - level];
+            for(int k = 0; k + 1 < nCoefficients - level; k++)
+            {
+                c[k] = 0.5 * (c[k] + c[k + 1]);
+            }
+        }
+        stackLower[top] = lower;
+        stackDepth[top] = depth + 1;
+        stackLower[top + 1] = 0.5 * (lower + upper);
+        stackDepth[top + 1] = depth + 1;
+        top += 2;
+    }
+    return squaredDistance;
+}
+
+float squaredDistanceToCurve()
+{
+    if(nControlPoints <= 2)
+    {
+        // A line is the quadratic with its middle control point halfway.
+        vec2 last = controlPoints[nControlPoints - 1];
+        return squaredDistanceToQuadratic(controlPoints[0], 0.5 * (controlPoints[0] + last), last);
+    }
+    if(nControlPoints == 3)
+    {
+        return squaredDistanceToQuadratic(controlPoints[0], controlPoints[1], controlPoints[2]);
+    }
+    return squaredDistanceToCurveOfHigherDegree();
+}
+
+void main()
+{
+    if(u_isResolvePass)
+    {
+        fragColor = vec4(u_color, 0.0);
+        return;
+    }
+
+    int first = curveIndex * TexelsPerCurve;
+    nControlPoints = int(texelFetch(u_controlPoints, first + MaxControlPoints).x);
+    for(int i = 0; i < nControlPoints; i++)
+    {
+        controlPoints[i] = texelFetch(u_controlPoints, first + i).xy;
+    }
+    float distance = sqrt(squaredDistanceToCurve());
+
+    // Coverage of a pixel-wide box filter across the stroke boundary.
+    float pixelSize = 0.7071 * length(fwidth(curvePosition));
+    float alpha = clamp((u_halfLineWidth - distance) / pixelSize + 0.5, 0.0, 1.0);
+    if(alpha <= 0.0)
+    {
+        discard;
+    }
+    fragColor = vec4(u_color, alpha);
+}
@@ -0,0 +1,45 @@
+#version 400 core
+#pragma optimize(on)
+
+const int MaxControlPoints = 7;
+const int TexelsPerCurve = MaxControlPoints + 1;
+
+uniform samplerBuffer u_controlPoints;
+uniform float u_halfLineWidth;
+uniform float u_pixelScale;
+uniform mat3 u_transformationMatrix;
+
+out vec2 curvePosition;
+flat out int curveIndex;
+
+void main()
+{
+    int first = gl_InstanceID * TexelsPerCurve;
+    int nControlPoints = int(texelFetch(u_controlPoints, first + MaxControlPoints).x);
+    vec2 p0 = texelFetch(u_controlPoints, first).xy;
+    vec2 chord = texelFetch(u_controlPoints, first + nControlPoints - 1).xy - p0;
+    float chordLength = length(chord);
+    vec2 axis = chordLength > 0.0 ? chord / chordLength : vec2(1.0, 0.0);
+    vec2 normal = vec2(-axis.y, axis.x);
+
+    // The bounding box of the control points in the frame of the chord contains their convex hull and thus the curve.
+    vec2 lower = vec2(1e30);
+    vec2 upper = vec2(-1e30);
+    for(int i = 0; i < nControlPoints; i++)
+    {
+        vec2 d = texelFetch(u_controlPoints, first + i).xy - p0;
+        vec2 c = vec2(dot(d, axis), dot(d, normal));
+        lower = min(lower, c);
+        upper = max(upper, c);
+    }
+
+    // Make room for the stroke and one pixel of antialiasing.
+    float curveUnitsPerNDC = 1.0 / min(length(u_transformationMatrix[0].xy), length(u_transformationMatrix[1].xy));
+    float margin = u_halfLineWidth + u_pixelScale * curveUnitsPerNDC;
+    vec2 corner = mix(lower - margin, upper + margin, vec2(gl_VertexID & 1, gl_VertexID >> 1));
+
+    curvePosition = p0 + corner.x * axis + corner.y * normal;
+    curveIndex = gl_InstanceID;
+    vec3 v = u_transformationMatrix * vec3(curvePosition, 1.0);
+    gl_Position = vec4(v.xy, 0.0, 1.0);
+}
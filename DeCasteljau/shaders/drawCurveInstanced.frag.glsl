@@ -0,0 +1,18 @@
+#version 400 core
+#pragma optimize(on)
+
+out vec4 fragColor;
+in vec2 segmentCoordinates;
+flat in float segmentLength;
+uniform float u_halfLineWidth;
+uniform vec3 u_color;
+void main()
+{
+    // Distance to the segment. Fragments around the end points form the round caps and joins.
+    vec2 d = vec2(segmentCoordinates.x - clamp(segmentCoordinates.x, 0.0, segmentLength), segmentCoordinates.y);
+    if(dot(d, d) > u_halfLineWidth * u_halfLineWidth)
+    {
+        discard;
+    }
+    fragColor = vec4(u_color.xyz, 1.0f);
+}
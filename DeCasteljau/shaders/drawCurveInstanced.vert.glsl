@@ -0,0 +1,29 @@
+#version 400 core
+#pragma optimize(on)
+
+uniform samplerBuffer u_points;
+uniform float u_halfLineWidth;
+uniform mat3 u_transformationMatrix;
+
+// Position of the vertex in the frame of the segment: x along the segment, y across it.
+out vec2 segmentCoordinates;
+flat out float segmentLength;
+
+void main()
+{
+    vec2 p0 = texelFetch(u_points, gl_InstanceID).xy;
+    vec2 p1 = texelFetch(u_points, gl_InstanceID + 1).xy;
+
+    segmentLength = length(p1 - p0);
+    vec2 lineDirection = segmentLength > 0.0 ? (p1 - p0) / segmentLength : vec2(1.0, 0.0);
+    vec2 lineNormal = vec2(-lineDirection.y, lineDirection.x);
+
+    // Extend the quad by the half line width on every side to make room for round caps and joins.
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    segmentCoordinates = vec2(mix(-u_halfLineWidth, segmentLength + u_halfLineWidth, corner.x),
+                              mix(-u_halfLineWidth, u_halfLineWidth, corner.y));
+
+    vec2 p = p0 + segmentCoordinates.x * lineDirection + segmentCoordinates.y * lineNormal;
+    vec3 v = u_transformationMatrix * vec3(p, 1.0);
+    gl_Position = vec4(v.xy, 0.0, 1.0);
+}
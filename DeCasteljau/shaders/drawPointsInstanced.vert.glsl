@@ -0,0 +1,15 @@
+#version 400 core
+#pragma optimize(on)
+
+uniform samplerBuffer u_points;
+uniform vec2 u_radius;
+uniform mat3 u_transformationMatrix;
+
+out vec2 corners;
+
+void main()
+{
+    vec3 v = u_transformationMatrix * vec3(texelFetch(u_points, gl_InstanceID).xy, 1);
+    corners = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+    gl_Position = vec4(v.xy + corners * u_radius, 0.0, 1.0);
+}